@@ -0,0 +1,104 @@
+#if !PICO_ON_DEVICE
+#define _POSIX_C_SOURCE 199309L
+#include <time.h>
+#endif
+
+#include "bench.h"
+#include "ssd1306.h"
+#include <stdio.h>
+
+#ifndef BENCH_REVISION
+#define BENCH_REVISION "unknown"
+#endif
+
+#if PICO_ON_DEVICE
+#include "hardware/structs/systick.h"
+
+// SysTick conta para baixo em 24 bits no clock do processador: um lote de
+// 20 ms a 125 MHz (2,5 M ciclos) cabe com folga antes de dar a volta
+#define BENCH_SYSTICK_MASK 0x00FFFFFFu
+
+static void bench_systick_start(void) {
+  systick_hw->csr = 0;
+  systick_hw->rvr = BENCH_SYSTICK_MASK;
+  systick_hw->cvr = 0;
+  systick_hw->csr = 0x5;  // ENABLE | CLKSOURCE (clock do processador)
+}
+
+static uint32_t bench_cycles(void) {
+  return systick_hw->cvr;
+}
+
+uint64_t bench_now_ns(void) {
+  return time_us_64() * 1000u;
+}
+#else
+uint64_t bench_now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + ts.tv_nsec;
+}
+#endif
+
+void bench_begin(uint8_t width, uint8_t height) {
+#if PICO_ON_DEVICE
+  bench_systick_start();
+  const char *platform = "rp2040";
+#else
+  const char *platform = "host";
+#endif
+  printf("{\"meta\":{\"platform\":\"%s\",\"revision\":\"%s\",\"width\":%d,\"height\":%d}}\n",
+         platform, BENCH_REVISION, width, height);
+}
+
+bench_result_t bench_measure(bench_fn_t fn, void *ctx) {
+  bench_result_t r = { .iters = 1, .total_ops = 0, .ns_per_op = 0, .cycles_per_op = -1 };
+  uint32_t it = 0;
+
+  // Calibração: dobra o lote até atingir a duração mínima
+  for (;;) {
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < r.iters; ++i)
+      fn(ctx, it++);
+    uint64_t dt = bench_now_ns() - t0;
+    r.total_ops += r.iters;
+    if (dt >= BENCH_BATCH_NS || r.iters >= (1u << 30))
+      break;
+    r.iters *= 2;
+  }
+
+  double best_ns = 0;
+  for (int rep = 0; rep < BENCH_REPEATS; ++rep) {
+#if PICO_ON_DEVICE
+    uint32_t c0 = bench_cycles();
+#endif
+    uint64_t t0 = bench_now_ns();
+    for (uint32_t i = 0; i < r.iters; ++i)
+      fn(ctx, it++);
+    uint64_t dt = bench_now_ns() - t0;
+#if PICO_ON_DEVICE
+    uint32_t cycles = (c0 - bench_cycles()) & BENCH_SYSTICK_MASK;
+#endif
+    r.total_ops += r.iters;
+
+    if (rep == 0 || dt < best_ns) {
+      best_ns = dt;
+#if PICO_ON_DEVICE
+      r.cycles_per_op = (double)cycles / r.iters;
+#endif
+    }
+  }
+  r.ns_per_op = best_ns / r.iters;
+  return r;
+}
+
+void bench_report(const char *bench, const char *case_name, const bench_result_t *r,
+                  const char *extra_json) {
+  printf("{\"bench\":\"%s\",\"case\":\"%s\",\"iters\":%lu,\"ns_per_op\":%.1f", bench, case_name,
+         (unsigned long)r->iters, r->ns_per_op);
+  if (r->cycles_per_op >= 0)
+    printf(",\"cycles_per_op\":%.1f", r->cycles_per_op);
+  if (extra_json)
+    printf(",%s", extra_json);
+  printf("}\n");
+}
@@ -0,0 +1,34 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdint.h>
+
+// Cada caso é repetido em lotes cujo tamanho dobra até o lote durar
+// BENCH_BATCH_NS; vale o melhor de BENCH_REPEATS lotes desse tamanho
+#define BENCH_BATCH_NS 20000000ull
+#define BENCH_REPEATS 3
+
+// Executa uma vez a operação medida; iteration permite variar a entrada
+typedef void (*bench_fn_t)(void *ctx, uint32_t iteration);
+
+typedef struct {
+  uint32_t iters;         // operações por lote
+  uint64_t total_ops;     // operações executadas, calibração incluída
+  double ns_per_op;
+  double cycles_per_op;   // negativo quando não há contador de ciclos (host)
+} bench_result_t;
+
+// Relógio monotônico: clock_gettime no host, time_us_64 na placa
+uint64_t bench_now_ns(void);
+
+// Imprime a linha de metadados (plataforma, revisão, geometria)
+void bench_begin(uint8_t width, uint8_t height);
+
+bench_result_t bench_measure(bench_fn_t fn, void *ctx);
+
+// Uma linha JSON por caso. extra_json, se não for NULL, são campos adicionais
+// já formatados (ex.: "\"bytes_per_frame\":12.5")
+void bench_report(const char *bench, const char *case_name, const bench_result_t *r,
+                  const char *extra_json);
+
+#endif // BENCH_H
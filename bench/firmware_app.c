@@ -0,0 +1,5 @@
+// Lógica do firmware sem o main() original, para o binário de benchmarks na
+// placa. Uma propriedade de fonte no CMake renomearia o main() também no
+// firmware normal, que compila o mesmo arquivo no mesmo diretório
+#define main firmware_main
+#include "embarcatech-adc-bitdoglab.c"
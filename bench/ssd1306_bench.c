@@ -0,0 +1,561 @@
+#include "bench.h"
+#include "display_state.h"
+#include "ssd1306.h"
+#include "ssd1306_fixed.h"
+#include "ssd1306_blit.h"
+#include "ssd1306_layer.h"
+#include "ssd1306_scene.h"
+#include "strip_chart.h"
+#include <stdio.h>
+#include <string.h>
+
+// Definidos em embarcatech-adc-bitdoglab.c, compilado com main=firmware_main
+extern ssd1306_t ssd;
+void init_i2c(void);
+void init_display(void);
+void update_display(const display_state_t *state);
+void draw_border(ssd1306_t *ssd, uint8_t style);
+extern ssd1306_layer_t border_layers[BORDER_STYLE_COUNT];
+
+// Instância de geometria fixa para comparar com o caminho genérico. Só o
+// desenho é medido, então ela não é inicializada nem enviada
+SSD1306_FIXED_DEFINE(bench_fb, 128, 64)
+
+// Barramento a 400 kHz: 9 bits por byte (8 de dados + ACK)
+#define BENCH_I2C_HZ 400000u
+
+// Transporte nulo: a medição cobre só a CPU (desenho, diff e montagem das
+// janelas); os bytes continuam contabilizados em ssd1306_stats_t
+static void null_write(void *ctx, uint8_t address, const uint8_t *src, size_t len) {
+  (void)ctx;
+  (void)address;
+  (void)src;
+  (void)len;
+}
+
+static const ssd1306_transport_t null_transport = { null_write, NULL, NULL };
+
+typedef struct {
+  uint8_t x, y, w, h;
+  bool fill;
+} rect_case_t;
+
+typedef struct {
+  uint8_t x0, y0, x1, y1;
+} line_case_t;
+
+typedef struct {
+  uint8_t len, y;
+} string_case_t;
+
+typedef struct {
+  uint8_t x, y;
+  ssd1306_blit_mode_t mode;
+} blit_case_t;
+
+typedef struct {
+  uint8_t style;
+  bool moving;
+  uint64_t frames;
+} frame_case_t;
+
+static void bench_fill(void *ctx, uint32_t it) {
+  (void)ctx;
+  ssd1306_fill(&ssd, it & 1);
+}
+
+static void bench_pixel(void *ctx, uint32_t it) {
+  (void)ctx;
+  ssd1306_pixel(&ssd, it % ssd.width, (it / ssd.width) % ssd.height, it & 1);
+}
+
+static void bench_rect(void *ctx, uint32_t it) {
+  const rect_case_t *c = ctx;
+  ssd1306_rect(&ssd, c->y, c->x, c->w, c->h, it & 1, c->fill);
+}
+
+// Retângulo como era desenhado antes de ssd1306_fill_area: um ssd1306_pixel
+// por pixel do contorno e do interior. Referência para ssd1306_rect
+static void bench_pixel_rect(void *ctx, uint32_t it) {
+  const rect_case_t *c = ctx;
+  bool value = it & 1;
+  for (uint8_t x = c->x; x < c->x + c->w; ++x) {
+    ssd1306_pixel(&ssd, x, c->y, value);
+    ssd1306_pixel(&ssd, x, c->y + c->h - 1, value);
+  }
+  for (uint8_t y = c->y; y < c->y + c->h; ++y) {
+    ssd1306_pixel(&ssd, c->x, y, value);
+    ssd1306_pixel(&ssd, c->x + c->w - 1, y, value);
+  }
+  if (c->fill) {
+    for (uint8_t x = c->x + 1; x < c->x + c->w - 1; ++x)
+      for (uint8_t y = c->y + 1; y < c->y + c->h - 1; ++y)
+        ssd1306_pixel(&ssd, x, y, value);
+  }
+}
+
+static void bench_fixed_fill(void *ctx, uint32_t it) {
+  (void)ctx;
+  bench_fb_fill(it & 1);
+}
+
+static void bench_fixed_pixel(void *ctx, uint32_t it) {
+  (void)ctx;
+  bench_fb_pixel(it % 128, (it / 128) % 64, it & 1);
+}
+
+static void bench_fixed_rect(void *ctx, uint32_t it) {
+  const rect_case_t *c = ctx;
+  if (c->fill)
+    bench_fb_fill_rect(c->x, c->y, c->x + c->w - 1, c->y + c->h - 1, it & 1);
+  else
+    bench_fb_rect(c->x, c->y, c->w, c->h, it & 1);
+}
+
+static void bench_line(void *ctx, uint32_t it) {
+  const line_case_t *c = ctx;
+  ssd1306_line(&ssd, c->x0, c->y0, c->x1, c->y1, it & 1);
+}
+
+static void bench_string(void *ctx, uint32_t it) {
+  const string_case_t *c = ctx;
+  static const char text[] = "X:4095 Y:2048 ab";
+  char str[sizeof(text)];
+  memcpy(str, text, c->len);
+  str[c->len] = '\0';
+  str[0] = 'A' + it % 26;
+  ssd1306_draw_string(&ssd, str, 0, c->y);
+}
+
+// Bitmap 16x16 com padrão xadrez e máscara circular grosseira
+static const uint8_t checker_data[32] = {
+  0x55, 0x55, 0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAA,
+  0x55, 0x55, 0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAA, 0x55, 0x55, 0xAA, 0xAA,
+};
+static const uint8_t round_data[32] = {
+  0xE0, 0x07, 0xF8, 0x1F, 0xFC, 0x3F, 0xFE, 0x7F, 0xFE, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+  0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFE, 0x7F, 0xFE, 0x7F, 0xFC, 0x3F, 0xF8, 0x1F, 0xE0, 0x07,
+};
+static const ssd1306_bitmap_t checker = { 16, 16, checker_data };
+static const ssd1306_bitmap_t round_mask = { 16, 16, round_data };
+
+static void bench_blit(void *ctx, uint32_t it) {
+  const blit_case_t *c = ctx;
+  ssd1306_blit(&ssd, &checker, &round_mask, c->x + (it & 1), c->y, c->mode);
+}
+
+// Borda redesenhada com as primitivas contra a camada pré-desenhada
+static void bench_border_raster(void *ctx, uint32_t it) {
+  (void)it;
+  ssd1306_fill(&ssd, false);
+  draw_border(&ssd, *(const uint8_t *)ctx);
+}
+
+static void bench_layer_copy(void *ctx, uint32_t it) {
+  (void)it;
+  ssd1306_layer_copy(&ssd, &border_layers[*(const uint8_t *)ctx]);
+}
+
+static void bench_layer_or(void *ctx, uint32_t it) {
+  (void)it;
+  ssd1306_layer_or(&ssd, &border_layers[*(const uint8_t *)ctx]);
+}
+
+// Trajetória do joystick: ondas triangulares defasadas nos dois eixos
+static uint16_t triangle(uint32_t phase) {
+  phase %= 128;
+  return (phase < 64 ? phase : 127 - phase) * 4095 / 63;
+}
+
+// Cursor 8x8 em XOR seguindo a trajetória: apaga e redesenha no lugar
+static void bench_sprite(void *ctx, uint32_t it) {
+  static ssd1306_view_t screen;
+  ssd1306_sprite_t *sprite = ctx;
+  if (!screen.ssd)
+    ssd1306_view_init(&screen, &ssd, 0, 0, ssd.width, ssd.height);
+  ssd1306_sprite_move(&screen, sprite, triangle(it) * (ssd.width - 8) / 4095,
+                      triangle(it * 3 + 17) * (ssd.height - 8) / 4095);
+}
+
+static void bench_frame(void *ctx, uint32_t it) {
+  frame_case_t *c = ctx;
+  display_state_t state = {
+    .x = c->moving ? triangle(it) : 2048,
+    .y = c->moving ? triangle(it * 3 + 17) : 2048,
+    .border_style = c->style,
+    .flags = STATE_FLAG_PWM,
+  };
+  update_display(&state);
+  ssd1306_send_diff(&ssd);
+  c->frames++;
+}
+
+// Painel de teste: borda dupla, duas leituras, duas barras, um gráfico em
+// varredura e o cursor. O mesmo conteúdo é desenhado em modo imediato (tela
+// limpa e redesenhada a cada quadro) e por uma cena retida
+#define DASH_PLOT_X 8
+#define DASH_PLOT_Y 30
+#define DASH_PLOT_W 112
+#define DASH_PLOT_H 28
+
+typedef enum {
+  DASH_IMMEDIATE_FULL,   // redesenha e envia a tela inteira
+  DASH_IMMEDIATE_DIFF,   // redesenha e envia as diferenças da cópia sombra
+  DASH_SCENE,            // cena: redesenha e envia só as áreas danificadas
+} dash_mode_t;
+
+typedef struct {
+  dash_mode_t mode;
+  bool moving;
+  uint64_t frames;
+} dash_case_t;
+
+typedef struct {
+  uint16_t x, y;
+  char str_x[8], str_y[8];
+} dash_state_t;
+
+static ssd1306_scene_t dash_scene;
+static ssd1306_node_t dash_border, dash_label_x, dash_label_y, dash_bar_x, dash_bar_y, dash_plot, dash_cursor;
+static strip_chart_t dash_scene_chart;
+
+// Histórico do modo imediato, redesenhado inteiro a cada quadro
+static strip_chart_t dash_chart;
+
+static const uint8_t dash_cursor_data[8] = { 0x3C, 0x7E, 0xFF, 0xFF, 0xFF, 0xFF, 0x7E, 0x3C };
+static const ssd1306_bitmap_t dash_cursor_bmp = { 8, 8, dash_cursor_data };
+
+static dash_state_t dash_state(const dash_case_t *c, uint32_t it) {
+  dash_state_t st = { .x = 2048, .y = 2048 };
+  if (c->moving) {
+    st.x = triangle(it);
+    st.y = triangle(it * 3 + 17);
+  }
+  snprintf(st.str_x, sizeof(st.str_x), "X:%4u", st.x);
+  snprintf(st.str_y, sizeof(st.str_y), "Y:%4u", st.y);
+  return st;
+}
+
+static uint8_t dash_cursor_x(const dash_state_t *st) {
+  return st->x * (ssd.width - 8) / 4095;
+}
+
+static uint8_t dash_cursor_y(const dash_state_t *st) {
+  return st->y * (ssd.height - 8) / 4095;
+}
+
+// Área interna do gráfico (sem os eixos), uma amostra por coluna
+static void dash_chart_init(strip_chart_t *chart) {
+  strip_chart_init(chart, DASH_PLOT_W - 1, DASH_PLOT_H - 1, 0, 4095, 1);
+}
+
+static void dash_scene_init(void) {
+  ssd1306_scene_init(&dash_scene, &ssd);
+  dash_chart_init(&dash_scene_chart);
+  ssd1306_node_border(&dash_border, 0, 0, ssd.width, ssd.height, SSD1306_BORDER_DOUBLE);
+  ssd1306_node_label(&dash_label_x, 8, 8, "X:    ");
+  ssd1306_node_label(&dash_label_y, 72, 8, "Y:    ");
+  ssd1306_node_bar(&dash_bar_x, 8, 18, 52, 8, 4095, false);
+  ssd1306_node_bar(&dash_bar_y, 68, 18, 52, 8, 4095, false);
+  ssd1306_node_plot(&dash_plot, DASH_PLOT_X, DASH_PLOT_Y, &dash_scene_chart);
+  ssd1306_node_sprite(&dash_cursor, 0, 0, &dash_cursor_bmp, NULL, SSD1306_BLIT_COPY);
+  ssd1306_node_t *const nodes[] = {
+    &dash_border, &dash_label_x, &dash_label_y, &dash_bar_x, &dash_bar_y, &dash_plot, &dash_cursor,
+  };
+  for (size_t i = 0; i < count_of(nodes); ++i)
+    ssd1306_scene_add(&dash_scene, nodes[i]);
+}
+
+static void dash_bar(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint16_t value) {
+  ssd1306_rect(&ssd, y, x, w, h, true, false);
+  uint8_t length = (uint32_t)value * (w - 4) / 4095;
+  if (length)
+    ssd1306_rect(&ssd, y + 2, x + 2, length, h - 4, true, true);
+}
+
+// Caminho imediato com as primitivas de tela inteira, como um laço principal
+// que limpa e redesenha tudo a cada quadro
+static void dash_immediate(const dash_state_t *st, bool push) {
+  if (push)
+    strip_chart_push(&dash_chart, st->x);
+
+  ssd1306_fill(&ssd, false);
+  ssd1306_rect(&ssd, 0, 0, ssd.width, ssd.height, true, false);
+  ssd1306_rect(&ssd, 2, 2, ssd.width - 4, ssd.height - 4, true, false);
+  ssd1306_draw_string(&ssd, st->str_x, 8, 8);
+  ssd1306_draw_string(&ssd, st->str_y, 72, 8);
+  dash_bar(8, 18, 52, 8, st->x);
+  dash_bar(68, 18, 52, 8, st->y);
+
+  ssd1306_vline(&ssd, DASH_PLOT_X, DASH_PLOT_Y, DASH_PLOT_Y + DASH_PLOT_H - 1, true);
+  ssd1306_hline(&ssd, DASH_PLOT_X, DASH_PLOT_X + DASH_PLOT_W - 1, DASH_PLOT_Y + DASH_PLOT_H - 1, true);
+  ssd1306_view_t plot;
+  ssd1306_view_init(&plot, &ssd, DASH_PLOT_X + 1, DASH_PLOT_Y, DASH_PLOT_W - 1, DASH_PLOT_H - 1);
+  strip_chart_redraw(&dash_chart, &plot);
+
+  ssd1306_blit(&ssd, &dash_cursor_bmp, NULL, dash_cursor_x(st), dash_cursor_y(st), SSD1306_BLIT_COPY);
+}
+
+// A cena recebe os mesmos valores; cada nó decide o que danificar
+static void dash_retained(const dash_state_t *st, bool push) {
+  ssd1306_scene_set_label(&dash_scene, &dash_label_x, st->str_x);
+  ssd1306_scene_set_label(&dash_scene, &dash_label_y, st->str_y);
+  ssd1306_scene_set_bar(&dash_scene, &dash_bar_x, st->x);
+  ssd1306_scene_set_bar(&dash_scene, &dash_bar_y, st->y);
+  if (push)
+    ssd1306_scene_plot_push(&dash_scene, &dash_plot, st->x);
+  ssd1306_node_move(&dash_cursor, dash_cursor_x(st), dash_cursor_y(st));
+  ssd1306_scene_render(&dash_scene);
+}
+
+static void bench_dashboard(void *ctx, uint32_t it) {
+  dash_case_t *c = ctx;
+  dash_state_t st = dash_state(c, it);
+
+  switch (c->mode) {
+    case DASH_IMMEDIATE_FULL:
+      dash_immediate(&st, c->moving);
+      ssd1306_send_data(&ssd);
+      break;
+    case DASH_IMMEDIATE_DIFF:
+      dash_immediate(&st, c->moving);
+      ssd1306_send_diff(&ssd);
+      break;
+    case DASH_SCENE:
+      dash_retained(&st, c->moving);
+      ssd1306_scene_send(&dash_scene);
+      break;
+  }
+  c->frames++;
+}
+
+// Histórico de 120 x 18 com 10 amostras por coluna: por quadro, uma coluna
+// nova desenhada na varredura contra uma faixa rolada por software (a mais
+// nova sempre à direita), que muda e reenvia o gráfico inteiro
+typedef struct {
+  strip_chart_t chart;
+  ssd1306_view_t view;
+  bool scroll;
+  uint64_t frames;
+} chart_case_t;
+
+static int chart_row(uint16_t v) {
+  return 17 - v * 17 / 4095;
+}
+
+static void chart_scroll(chart_case_t *c) {
+  uint32_t head = strip_chart_head(&c->chart);
+  uint32_t count = head < 119 ? head : 119;
+  ssd1306_view_fill(&c->view, false);
+  for (uint32_t k = 0; k < count; ++k) {
+    const strip_chart_column_t *col = &c->chart.columns[(head - count + k) % 120];
+    ssd1306_view_vline(&c->view, 120 - count + k, chart_row(col->hi), chart_row(col->lo), true);
+  }
+}
+
+static void bench_chart(void *ctx, uint32_t it) {
+  chart_case_t *c = ctx;
+  for (uint32_t i = 0; i < 10; ++i)
+    strip_chart_push(&c->chart, triangle(it * 10 + i));
+  if (c->scroll)
+    chart_scroll(c);
+  else
+    strip_chart_draw(&c->chart, &c->view);
+  ssd1306_send_diff(&ssd);
+  c->frames++;
+}
+
+static void run_primitives(void) {
+  char name[48];
+  bench_result_t r;
+
+  // Cada primitiva é medida no caminho genérico e no especializado (fixed_*)
+  r = bench_measure(bench_fill, NULL);
+  bench_report("ssd1306_fill", "full", &r, NULL);
+  r = bench_measure(bench_fixed_fill, NULL);
+  bench_report("fixed_fill", "full", &r, NULL);
+
+  r = bench_measure(bench_pixel, NULL);
+  bench_report("ssd1306_pixel", "sweep", &r, NULL);
+  r = bench_measure(bench_fixed_pixel, NULL);
+  bench_report("fixed_pixel", "sweep", &r, NULL);
+
+  // Posições alinhadas às páginas e desalinhadas, contorno e preenchido;
+  // pixel_rect é o laço por pixel anterior ao preenchimento por páginas
+  static const rect_case_t rects[] = {
+    { 8, 8, 8, 8, false },    { 8, 8, 8, 8, true },
+    { 5, 3, 8, 8, false },    { 5, 3, 8, 8, true },
+    { 8, 8, 32, 32, false },  { 8, 8, 32, 32, true },
+    { 5, 3, 32, 32, false },  { 5, 3, 32, 32, true },
+    { 0, 0, 128, 64, false }, { 0, 0, 128, 64, true },
+    { 5, 3, 100, 57, false }, { 5, 3, 100, 57, true },
+  };
+  for (size_t i = 0; i < count_of(rects); ++i) {
+    const rect_case_t *c = &rects[i];
+    snprintf(name, sizeof(name), "%ux%u@%u,%u %s", c->w, c->h, c->x, c->y, c->fill ? "fill" : "outline");
+    r = bench_measure(bench_pixel_rect, (void *)c);
+    bench_report("pixel_rect", name, &r, NULL);
+    r = bench_measure(bench_rect, (void *)c);
+    bench_report("ssd1306_rect", name, &r, NULL);
+    r = bench_measure(bench_fixed_rect, (void *)c);
+    bench_report("fixed_rect", name, &r, NULL);
+  }
+
+  static const line_case_t lines[] = {
+    { 0, 13, 127, 13 },   // horizontal
+    { 61, 0, 61, 63 },    // vertical
+    { 0, 0, 127, 63 },    // diagonal longa
+    { 10, 10, 20, 17 },   // diagonal curta
+    { 20, 60, 30, 2 },    // íngreme
+  };
+  for (size_t i = 0; i < count_of(lines); ++i) {
+    const line_case_t *c = &lines[i];
+    snprintf(name, sizeof(name), "%u,%u-%u,%u", c->x0, c->y0, c->x1, c->y1);
+    r = bench_measure(bench_line, (void *)c);
+    bench_report("ssd1306_line", name, &r, NULL);
+  }
+
+  static const uint8_t styles[BORDER_STYLE_COUNT] = { 0, 1, 2 };
+  for (uint8_t i = 0; i < BORDER_STYLE_COUNT; ++i) {
+    snprintf(name, sizeof(name), "border %u", i);
+    r = bench_measure(bench_border_raster, (void *)&styles[i]);
+    bench_report("border_raster", name, &r, NULL);
+    r = bench_measure(bench_layer_copy, (void *)&styles[i]);
+    bench_report("layer_copy", name, &r, NULL);
+    r = bench_measure(bench_layer_or, (void *)&styles[i]);
+    bench_report("layer_or", name, &r, NULL);
+  }
+
+  // Bitmap 16x16 alinhado e desalinhado às páginas, em cada modo
+  static const char *const mode_names[] = { "copy", "or", "and", "xor", "mask" };
+  static const blit_case_t blits[] = {
+    { 8, 8, SSD1306_BLIT_COPY }, { 8, 8, SSD1306_BLIT_XOR }, { 8, 8, SSD1306_BLIT_MASK },
+    { 5, 3, SSD1306_BLIT_COPY }, { 5, 3, SSD1306_BLIT_OR },  { 5, 3, SSD1306_BLIT_AND },
+    { 5, 3, SSD1306_BLIT_XOR },  { 5, 3, SSD1306_BLIT_MASK },
+  };
+  for (size_t i = 0; i < count_of(blits); ++i) {
+    const blit_case_t *c = &blits[i];
+    snprintf(name, sizeof(name), "16x16@%u,%u %s", c->x, c->y, mode_names[c->mode]);
+    r = bench_measure(bench_blit, (void *)c);
+    bench_report("ssd1306_blit", name, &r, NULL);
+  }
+
+  static const uint8_t square[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+  static const ssd1306_bitmap_t square_bmp = { 8, 8, square };
+  ssd1306_sprite_t sprite;
+  ssd1306_sprite_init(&sprite, &square_bmp, NULL, SSD1306_BLIT_XOR);
+  r = bench_measure(bench_sprite, &sprite);
+  bench_report("ssd1306_sprite_move", "8x8 xor", &r, NULL);
+
+  // y = 8 usa a cópia direta dos glifos; y = 11 a mescla de duas páginas
+  static const string_case_t strings[] = {
+    { 1, 8 }, { 8, 8 }, { 16, 8 }, { 1, 11 }, { 8, 11 }, { 16, 11 },
+  };
+  for (size_t i = 0; i < count_of(strings); ++i) {
+    const string_case_t *c = &strings[i];
+    snprintf(name, sizeof(name), "%u chars y=%u", c->len, c->y);
+    r = bench_measure(bench_string, (void *)c);
+    bench_report("ssd1306_draw_string", name, &r, NULL);
+  }
+}
+
+// Quadro completo do laço principal: update_display + envio diferencial
+static void run_frames(void) {
+  char name[48];
+  char extra[96];
+
+  for (uint8_t style = 0; style < BORDER_STYLE_COUNT; ++style) {
+    for (int moving = 1; moving >= 0; --moving) {
+      frame_case_t c = { .style = style, .moving = moving, .frames = 0 };
+      ssd1306_reset_stats(&ssd);
+      bench_result_t r = bench_measure(bench_frame, &c);
+
+      const ssd1306_stats_t *stats = ssd1306_get_stats(&ssd);
+      double bytes = (double)stats->bus_bytes / c.frames;
+      snprintf(name, sizeof(name), "border %u %s", style, moving ? "moving" : "idle");
+      snprintf(extra, sizeof(extra), "\"bytes_per_frame\":%.1f,\"bus_us_per_frame\":%.1f",
+               bytes, bytes * 9 * 1e6 / BENCH_I2C_HZ);
+      bench_report("frame", name, &r, extra);
+    }
+  }
+}
+
+static void run_chart(void) {
+  static chart_case_t c;
+  char extra[96];
+
+  for (int scroll = 0; scroll <= 1; ++scroll) {
+    ssd1306_fill(&ssd, false);
+    ssd1306_send_data(&ssd);
+    strip_chart_init(&c.chart, 120, 18, 0, 4095, 10);
+    ssd1306_view_init(&c.view, &ssd, 4, 20, 120, 18);
+    c.scroll = scroll;
+    c.frames = 0;
+    ssd1306_reset_stats(&ssd);
+    bench_result_t r = bench_measure(bench_chart, &c);
+
+    const ssd1306_stats_t *stats = ssd1306_get_stats(&ssd);
+    double bytes = (double)stats->bus_bytes / c.frames;
+    snprintf(extra, sizeof(extra), "\"bytes_per_frame\":%.1f,\"bus_us_per_frame\":%.1f",
+             bytes, bytes * 9 * 1e6 / BENCH_I2C_HZ);
+    bench_report("strip_chart", scroll ? "scroll" : "sweep", &r, extra);
+  }
+}
+
+// Painel completo em modo imediato e pela cena retida, com o cursor e os
+// valores em movimento e parados
+static void run_dashboard(void) {
+  static const char *const mode_names[] = { "immediate full", "immediate diff", "scene" };
+  char name[48];
+  char extra[160];
+
+  for (int moving = 1; moving >= 0; --moving) {
+    for (dash_mode_t mode = DASH_IMMEDIATE_FULL; mode <= DASH_SCENE; ++mode) {
+      dash_case_t c = { .mode = mode, .moving = moving, .frames = 0 };
+      ssd1306_fill(&ssd, false);
+      ssd1306_send_data(&ssd);
+      dash_chart_init(&dash_chart);
+      dash_scene_init();
+      ssd1306_reset_stats(&ssd);
+      bench_result_t r = bench_measure(bench_dashboard, &c);
+
+      const ssd1306_stats_t *stats = ssd1306_get_stats(&ssd);
+      double bytes = (double)stats->bus_bytes / c.frames;
+      snprintf(name, sizeof(name), "%s %s", mode_names[mode], moving ? "moving" : "idle");
+      int len = snprintf(extra, sizeof(extra), "\"bytes_per_frame\":%.1f,\"bus_us_per_frame\":%.1f",
+                         bytes, bytes * 9 * 1e6 / BENCH_I2C_HZ);
+      if (mode == DASH_SCENE)
+        snprintf(extra + len, sizeof(extra) - len, ",\"nodes_per_frame\":%.2f,\"rects_per_frame\":%.2f",
+                 (double)dash_scene.stats.nodes_drawn / c.frames, (double)dash_scene.stats.damage_rects / c.frames);
+      bench_report("dashboard", name, &r, extra);
+    }
+  }
+}
+
+int main() {
+  stdio_init_all();
+#if PICO_ON_DEVICE
+  sleep_ms(2000);  // tempo para o host abrir a serial USB
+#endif
+
+  // Mesma inicialização do firmware; as linhas fora do formato JSON que
+  // init_display imprime são apenas informativas
+  init_i2c();
+  init_display();
+  ssd1306_wait(&ssd);
+  ssd1306_set_transport(&ssd, &null_transport, NULL);
+
+  bench_begin(ssd.width, ssd.height);
+  run_primitives();
+  ssd1306_fill(&ssd, false);
+  run_frames();
+  run_dashboard();
+  run_chart();
+  printf("{\"done\":true}\n");
+
+#if PICO_ON_DEVICE
+  while (true)
+    tight_loop_contents();
+#endif
+  return 0;
+}
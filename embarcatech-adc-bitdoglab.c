@@ -21,8 +21,25 @@
  #include "hardware/i2c.h"
  #include "hardware/adc.h"
  #include "inc/ssd1306.h"
+ #include "inc/ssd1306_fixed.h"
+ #include "inc/ssd1306_blit.h"
+ #include "inc/ssd1306_layer.h"
  #include "inc/font.h"
- #include "hardware/pwm.h"
+ #include "inc/adc_sampler.h"
+ #include "inc/joystick_filter.h"
+ #include "inc/spsc_queue.h"
+ #include "inc/display_state.h"
+ #include "inc/trace.h"
+ #include "inc/scheduler.h"
+ #include "inc/button.h"
+ #include "inc/stream.h"
+ #include "inc/led_fade.h"
+ #include "inc/joystick_cal.h"
+ #include "inc/strip_chart.h"
+ #include "pico/multicore.h"
+ #include "pico/flash.h"
+ #include "pico/stdio_usb.h"
+ #include "tusb.h"
  
  // Definições dos pinos GPIO
  #define LED_GREEN 11      // LED verde do RGB
@@ -36,96 +53,130 @@
  #define I2C_SDA 14        // Pino de dados I2C
  #define I2C_SCL 15        // Pino de clock I2C
  #define endereco 0x3C     // Endereço I2C do display OLED
+ #define DISPLAY_WIDTH 128  // Largura do painel em pixels
+ #define DISPLAY_HEIGHT 64  // Altura do painel em pixels
+ #define ADC_FRAME_RATE 4000  // Quadros X/Y por segundo amostrados pelo ADC
+ #define SAMPLE_PERIOD_US 1000     // Leitura do anel do ADC e filtragem (1 kHz)
+ #define CONTROL_PERIOD_US 2000    // Atualização dos LEDs (500 Hz)
+ #define DISPLAY_PERIOD_US 20000   // Quadros do display (50 Hz)
+ #define DISPLAY_MAX_PERIOD_US 100000  // Limite da redução adaptativa (10 Hz)
+ #define BUTTON_PERIOD_US 2000     // Eventos dos botões (500 Hz)
+ #define STREAM_PERIOD_US 2000     // Envio dos quadros de streaming pela USB
+ #define REPORT_PERIOD_US 5000000  // Resumo do escalonador na serial
+ #define LED_TRACK_FADE_US 40000   // Suavização do brilho ao seguir o joystick
+ #define LED_TOGGLE_FADE_US 300000 // Fade ao ligar/desligar os LEDs (botão A, LED verde)
+ #define HISTORY_SAMPLES 10        // Saídas do filtro (250 Hz) por coluna do histórico: 25 colunas/s
+ #define HISTORY_LEFT 4            // Faixas do histórico, dentro da borda dupla
+ #define HISTORY_WIDTH 120
+ #define HISTORY_HEIGHT 18
+ #define HISTORY_X_TOP 20          // Faixa do eixo X
+ #define HISTORY_Y_TOP 41          // Faixa do eixo Y
+ 
+ // Modo de dois núcleos: o núcleo 0 cuida da aquisição e dos LEDs, o núcleo 1
+ // do desenho e do display. Com 0, tudo roda em sequência no núcleo 0
+ #ifndef DUAL_CORE
+ #define DUAL_CORE 1
+ #endif
  
  // Variáveis globais para controle de estado
- volatile bool led_green_state = false;    // Estado do LED verde
- volatile bool pwm_enabled = true;         // Estado do PWM
- volatile uint8_t border_style = 0;        // Estilo atual da borda
- volatile uint32_t last_button_time = 0;   // Último tempo de pressionamento do botão
- const uint32_t DEBOUNCE_DELAY = 200000;   // Delay para debounce (200ms)
- ssd1306_t ssd;                           // Estrutura do display
+ bool led_green_state = false;            // Estado do LED verde
+ bool pwm_enabled = true;                 // Estado do PWM
+ uint8_t border_style = 0;                // Estilo atual da borda
+ button_t buttons[2];                     // Máquinas de estado do joystick e do botão A
+ SSD1306_FIXED_DEFINE(ssd, DISPLAY_WIDTH, DISPLAY_HEIGHT)  // Display, buffers estáticos e desenho especializado
+ ssd1306_group_t displays;                // Displays enviados em rodízio
+ ssd1306_view_t readout_view;             // Janela das leituras do ADC
+ ssd1306_view_t screen_view;              // Tela inteira (cursor)
+ ssd1306_sprite_t cursor;                 // Quadrado que segue o joystick
+ ssd1306_view_t history_x_view;           // Faixa do histórico do eixo X
+ ssd1306_view_t history_y_view;           // Faixa do histórico do eixo Y
+ strip_chart_t history_x;                 // Histórico do eixo X (mín./máx. por coluna)
+ strip_chart_t history_y;                 // Histórico do eixo Y
+ ssd1306_layer_t border_layers[BORDER_STYLE_COUNT];  // Bordas pré-desenhadas, uma por estilo
+ uint32_t border_storage[BORDER_STYLE_COUNT][SSD1306_LAYER_WORDS(DISPLAY_WIDTH, DISPLAY_HEIGHT)];
+ const uint8_t cursor_pixels[8] = { 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+ const ssd1306_bitmap_t cursor_bitmap = { 8, 8, cursor_pixels };  // Quadrado 8x8 cheio
  bool cor = true;                         // Cor atual do display (true = branco)
+ #if TRACE_ENABLED
+ bool trace_dump_requested = false;         // Dump pedido por pressão longa
+ volatile uint32_t i2c_start_time = 0;      // Início da transferência em andamento
+ #endif
+ #if DUAL_CORE
+ spsc_queue_t state_queue;                // Fila de estados do núcleo 0 para o núcleo 1
+ display_state_t state_storage[8];        // Armazenamento da fila (potência de 2)
+ #endif
+ scheduler_t scheduler;                   // Tarefas periódicas do núcleo 0
+ joystick_filter_t filter_x;              // Filtro do eixo X
+ joystick_filter_t filter_y;              // Filtro do eixo Y
+ joystick_map_t map_x;                    // Coeficientes do eixo X (PWM e linha do quadrado)
+ joystick_map_t map_y;                    // Coeficientes do eixo Y (PWM e coluna do quadrado)
+ joystick_cal_run_t cal_run;              // Rotina de calibração em andamento
+ bool cal_armed = false;                  // Pressão longa: calibra ao soltar o botão
+ bool cal_pending = false;                // Calibração terminada, a gravar e relatar no loop principal
+ joystick_cal_result_t cal_result;        // Resultado da calibração terminada
+ joystick_cal_t cal_profile;              // Perfil medido, à espera da gravação na flash
+ led_fade_t leds;                         // Fades dos LEDs RGB, aplicados por DMA
+ int led_red, led_green, led_blue;        // Canais de cada LED no motor de fades
+ stream_t stream;                         // Streaming binário das amostras (duplo clique no botão A)
+ uint8_t stream_batch[4 * STREAM_FRAME_BYTES]; // Bytes entregues à USB em uma escrita
  
-/**
- * Calcula o valor PWM baseado no valor do ADC
- * Quando o joystick está no centro (2048), o LED fica apagado
- * O brilho aumenta conforme o joystick se afasta do centro em qualquer direção
- * @param value: valor do ADC (0-4095)
- * @return: valor do PWM (0-4095)
- */
-uint16_t calculate_pwm(uint16_t value) {
-    const uint16_t center = 2048;
-    const uint16_t deadzone = 210; // Zona morta para evitar flutuações no centro
-    
-    // Calcula a distância do centro
-    int32_t diff = abs((int32_t)value - center);
-    
-    // Se estiver dentro da zona morta, mantém LED apagado
-    if (diff < deadzone) {
-        return 0;
-    }
-    
-    // Calcula o brilho proporcionalmente à distância do centro
-    // Subtrai a zona morta para ter uma transição suave
-    diff -= deadzone;
-    
-    // Mapeia o valor para 0-4095, considerando que a distância máxima é 2048 - deadzone
-    uint32_t pwm = (diff * 4095) / (2048 - deadzone);
-    
-    // Limita o valor máximo
-    if (pwm > 4095) {
-        pwm = 4095;
-    }
-    
-    return (uint16_t)pwm;
-}
-
-
-void draw_square(ssd1306_t *ssd, uint8_t x, uint8_t y, uint8_t size) {
-    ssd1306_rect(ssd, x, y, size, size, true, true); // Retângulo preenchido
-}
-
-/**
- * Calcula a posição de um elemento no display com base no valor ADC.
- * @param adc_value: Valor do ADC (0-4095)
- * @param max: Valor máximo permitido (limite do display)
- * @param invert: Inverte o valor (eixo invertido, se true)
- * @return: Posição mapeada no intervalo permitido
- */
-uint8_t calculate_position(uint16_t adc_value, uint8_t max, bool invert) {
-    // Inverte o valor se necessário
-    if (invert) {
-        adc_value = 4095 - adc_value;
-    }
-    
-    // Calcula a posição com limites seguros
-    uint8_t pos = (adc_value * (max - 8)) / 4095;
-    return pos;
-}
-
 /**
  * Callback para tratamento de interrupções GPIO
- * Implementa debounce e controle dos botões:
- * - JOYSTICK_BTN alterna o LED verde e muda o estilo da borda
- * - BUTTON_A ativa/desativa os LEDs RGB
+ * Apenas enfileira a borda com o instante; debounce e gestos são tratados
+ * fora da interrupção, na tarefa dos botões (handle_button)
  */
  void gpio_callback(uint gpio, uint32_t events) {
-    uint32_t current_time = time_us_32();
-    
-    if (current_time - last_button_time < DEBOUNCE_DELAY) {
-        return;
-    }
-    
-    last_button_time = current_time;
-
-    if (gpio == JOYSTICK_BTN) {
-        led_green_state = !led_green_state;
-        gpio_put(LED_GREEN, led_green_state);  // Este controle está correto
-        border_style = (border_style + 1) % 3;
-    } else if (gpio == BUTTON_A) {
-        pwm_enabled = !pwm_enabled;
-    }
-}
+     button_queue_edge(gpio, events);
+ }
+ 
+ /**
+  * Aplica um perfil de calibração: zona morta dos filtros e coeficientes de
+  * mapeamento do caminho quente
+  * @param cal Perfil a aplicar
+  */
+ void apply_calibration(const joystick_cal_t *cal) {
+     joystick_filter_set_zone(&filter_x, cal->x.center, cal->x.deadzone);
+     joystick_filter_set_zone(&filter_y, cal->y.center, cal->y.deadzone);
+     joystick_map_init(&map_x, &cal->x, DISPLAY_HEIGHT, true);   // Eixo X invertido move as linhas
+     joystick_map_init(&map_y, &cal->y, DISPLAY_WIDTH, false);   // Eixo Y move as colunas
+ }
+ 
+ /**
+  * Trata os gestos já filtrados dos botões. Cada ação tem o próprio gesto, e
+  * o clique só é emitido quando não houve pressão longa nem duplo clique:
+  * - JOYSTICK_BTN: o clique alterna o LED verde e muda o estilo da borda; a
+  *   pressão longa, ao soltar, inicia a calibração do joystick
+  * - BUTTON_A: o clique ativa/desativa os LEDs RGB; o duplo clique liga/
+  *   desliga o streaming das amostras; com a instrumentação ativa, a pressão
+  *   longa pede o dump
+  * @param pin Pino do botão
+  * @param gesture Gesto detectado
+  */
+ void handle_button(uint pin, button_gesture_t gesture) {
+     if (pin == JOYSTICK_BTN && gesture == BUTTON_CLICK) {
+         led_green_state = !led_green_state;
+         led_fade_to(&leds, led_green, led_green_state ? LED_FADE_WRAP : 0, LED_TOGGLE_FADE_US, LED_EASE_IN_OUT);
+         border_style = (border_style + 1) % BORDER_STYLE_COUNT;
+     } else if (pin == JOYSTICK_BTN && gesture == BUTTON_LONG_PRESS) {
+         cal_armed = true;
+     } else if (pin == JOYSTICK_BTN && gesture == BUTTON_RELEASE && cal_armed) {
+         // Começa com o joystick já solto; a rotina espera ele assentar
+         cal_armed = false;
+         joystick_cal_begin(&cal_run, time_us_32());
+     } else if (pin == BUTTON_A && gesture == BUTTON_CLICK) {
+         pwm_enabled = !pwm_enabled;
+     } else if (pin == BUTTON_A && gesture == BUTTON_DOUBLE_CLICK) {
+         if (stream.active) {
+             stream_stop(&stream);
+         } else {
+             stream_start(&stream);
+         }
+ #if TRACE_ENABLED
+     } else if (pin == BUTTON_A && gesture == BUTTON_LONG_PRESS) {
+         trace_dump_requested = true;
+ #endif
+     }
+ }
  
  /**
   * Inicializa os pinos GPIO
@@ -136,27 +187,28 @@ uint8_t calculate_position(uint16_t adc_value, uint8_t max, bool invert) {
      gpio_init(JOYSTICK_BTN);
      gpio_set_dir(JOYSTICK_BTN, GPIO_IN);
      gpio_pull_up(JOYSTICK_BTN);
-     gpio_set_irq_enabled_with_callback(JOYSTICK_BTN, GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
+     button_init(&buttons[0], JOYSTICK_BTN);
+     gpio_set_irq_enabled_with_callback(JOYSTICK_BTN, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &gpio_callback);
      
      // Configuração do botão A
      gpio_init(BUTTON_A);
      gpio_set_dir(BUTTON_A, GPIO_IN);
      gpio_pull_up(BUTTON_A);
-     gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL, true, &gpio_callback);
- 
-     // Configuração do LED verde
-     gpio_init(LED_GREEN);
-     gpio_set_dir(LED_GREEN, GPIO_OUT);
+     button_init(&buttons[1], BUTTON_A);
+     gpio_set_irq_enabled_with_callback(BUTTON_A, GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE, true, &gpio_callback);
  }
  
  /**
   * Inicializa o ADC
-  * Configura os pinos do joystick como entradas analógicas
+  * Configura os pinos do joystick como entradas analógicas e inicia a
+  * amostragem contínua dos dois eixos (round-robin + FIFO + DMA)
   */
  void init_adc() {
      adc_init();
      adc_gpio_init(JOYSTICK_X);
      adc_gpio_init(JOYSTICK_Y);
+     adc_sampler_init(ADC_FRAME_RATE);
+     adc_sampler_start();
  }
  
  /**
@@ -172,34 +224,45 @@ uint8_t calculate_position(uint16_t adc_value, uint8_t max, bool invert) {
  }
  
  /**
-  * Inicializa o PWM para os LEDs RGB
-  * Configura a frequência e resolução do PWM
+  * Inicializa o PWM para os três LEDs RGB
+  * Resolução de 12 bits; os níveis são aplicados pelo DMA a cada período
+  * (inc/led_fade.c), então o laço de controle apenas define alvos
   */
  void init_pwm() {
-     gpio_set_function(LED_RED, GPIO_FUNC_PWM);
-     gpio_set_function(LED_BLUE, GPIO_FUNC_PWM);
- 
-     uint slice_red = pwm_gpio_to_slice_num(LED_RED);
-     uint slice_blue = pwm_gpio_to_slice_num(LED_BLUE);
- 
-     pwm_set_wrap(slice_red, 4095);    // Define resolução máxima
-     pwm_set_wrap(slice_blue, 4095);
- 
-     pwm_set_enabled(slice_red, true);
-     pwm_set_enabled(slice_blue, true);
+     led_fade_init(&leds);
+     led_red = led_fade_add(&leds, LED_RED);
+     led_green = led_fade_add(&leds, LED_GREEN);
+     led_blue = led_fade_add(&leds, LED_BLUE);
  }
  
+ #if TRACE_ENABLED
  /**
-  * Inicializa o display OLED
-  * Configura o display e limpa a tela
+  * Callback de término da transferência (IRQ do DMA): registra o tempo de
+  * barramento desde o disparo em flush_display
   */
- void init_display() {
-     ssd1306_init(&ssd, WIDTH, HEIGHT, false, endereco, I2C_PORT);
-     ssd1306_config(&ssd);
-     ssd1306_send_data(&ssd);
+ void trace_i2c_done(void *arg) {
+     trace_record(TRACE_STAGE_I2C_BUS, i2c_start_time, time_us_32());
+ }
+ #endif
  
-     ssd1306_fill(&ssd, false);    // Limpa o display
-     ssd1306_send_data(&ssd);
+ /**
+  * Dispara o envio diferencial do quadro por DMA em todos os displays
+  * @return: false se algum ainda estiver com a transferência anterior em
+  * andamento (ele é atendido primeiro na próxima chamada)
+  */
+ bool flush_display() {
+     TRACE_BEGIN(t_flush);
+     size_t flushed = ssd1306_group_flush(&displays);
+ #if TRACE_ENABLED
+     // Sem nenhum envio iniciado o barramento está com a transferência
+     // anterior, que ainda vai registrar o próprio início. O término de uma
+     // nova não chega antes desta escrita: o barramento leva dezenas de µs
+     if (flushed > 0)
+         i2c_start_time = t_flush;
+ #endif
+     bool started = flushed == displays.count;
+     TRACE_END(TRACE_STAGE_FLUSH, t_flush);
+     return started;
  }
  
  /**
@@ -232,67 +295,405 @@ uint8_t calculate_position(uint16_t adc_value, uint8_t max, bool invert) {
      }
  }
  
+ /**
+  * Desenha a borda no estilo informado
+  */
+ void draw_border(ssd1306_t *ssd, uint8_t style) {
+     switch (style) {
+         case 0:
+             ssd1306_rect(ssd, 0, 0, ssd->width, ssd->height, true, false);
+             break;
+         case 1:
+             draw_dotted_rect(ssd, 0, 0, ssd->width, ssd->height);
+             break;
+         case 2:
+             draw_double_rect(ssd, 0, 0, ssd->width, ssd->height);
+             break;
+     }
+ }
+ 
+ /**
+  * Inicializa o display OLED
+  * Configura o display (ssd1306_init já envia a configuração), limpa a tela e
+  * informa o tempo de inicialização e o tráfego gerado no barramento
+  */
+ void init_display() {
+     uint64_t start = time_us_64();
+     ssd_init(false, endereco, I2C_PORT);
+     uint64_t config_us = time_us_64() - start;
+     const ssd1306_stats_t *stats = ssd1306_get_stats(&ssd);
+     printf("Display: configuracao em %llu us (%lu transacoes, %lu bytes)\n",
+            (unsigned long long)config_us, (unsigned long)stats->transactions, (unsigned long)stats->bus_bytes);
+ 
+     ssd_enable_shadow();  // Permite descartar quadros idênticos ao último enviado
+     ssd_fill(false);      // Limpa o display
+     ssd1306_reset_stats(&ssd);
+     start = time_us_64();
+     ssd1306_send_data(&ssd);
+     printf("Display: quadro completo em %llu us (%lu transacoes, %lu bytes)\n",
+            (unsigned long long)(time_us_64() - start), (unsigned long)stats->transactions, (unsigned long)stats->bus_bytes);
+     ssd1306_reset_stats(&ssd);
+ #if TRACE_ENABLED
+     ssd1306_set_callback(&ssd, trace_i2c_done, NULL);
+ #endif
+     ssd1306_view_init(&readout_view, &ssd, 8, 8, DISPLAY_WIDTH - 16, 8);
+     ssd1306_view_init(&screen_view, &ssd, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+     ssd1306_view_init(&history_x_view, &ssd, HISTORY_LEFT, HISTORY_X_TOP, HISTORY_WIDTH, HISTORY_HEIGHT);
+     ssd1306_view_init(&history_y_view, &ssd, HISTORY_LEFT, HISTORY_Y_TOP, HISTORY_WIDTH, HISTORY_HEIGHT);
+     ssd1306_sprite_init(&cursor, &cursor_bitmap, NULL, SSD1306_BLIT_XOR);
+
+     // Cada estilo de borda é desenhado uma única vez em sua camada
+     for (uint8_t style = 0; style < BORDER_STYLE_COUNT; ++style) {
+         ssd1306_layer_init(&border_layers[style], DISPLAY_WIDTH, DISPLAY_HEIGHT, border_storage[style]);
+         draw_border(&border_layers[style].canvas, style);
+     }
+     ssd1306_group_init(&displays);
+     ssd1306_group_add(&displays, &ssd);
+ }
+ 
+ /**
+  * Atualiza o framebuffer com a borda, as leituras e a posição do quadrado
+  * A tela só é redesenhada por inteiro quando o estilo da borda muda, copiando
+  * a camada pré-desenhada do estilo.
+  * O quadrado é um sprite em XOR: apagá-lo restaura exatamente o que havia
+  * por baixo (borda, leituras ou histórico), então cada quadro toca só as
+  * colunas dele.
+  * Os históricos dos eixos desenham só as colunas fechadas desde o último
+  * quadro (e a marca de varredura); a tela inteira só ao trocar a borda.
+  * O envio fica a cargo de ssd1306_send_diff_async, que transmite somente as
+  * colunas que de fato mudaram (com o joystick parado, só as colunas novas
+  * do histórico)
+  * @param state: estado recebido do laço de controle
+  */
+ void update_display(const display_state_t *state) {
+     static int16_t last_style = -1;
+     char str_x[8];
+     char str_y[8];
+ 
+     uint8_t square_x = state->pos_x;
+     uint8_t square_y = state->pos_y;
+ 
+     if (state->border_style != last_style) {
+         ssd1306_layer_copy(&ssd, &border_layers[state->border_style]);
+         last_style = state->border_style;
+         ssd1306_sprite_forget(&cursor);
+         strip_chart_redraw(&history_x, &history_x_view);
+         strip_chart_redraw(&history_y, &history_y_view);
+     } else {
+         // Apaga antes de redesenhar as leituras, que o quadrado pode cobrir
+         ssd1306_sprite_hide(&screen_view, &cursor);
+     }
+ 
+     // Leituras do ADC na janela da segunda página (y alinhado a 8: cópia
+     // direta dos glifos)
+     // Durante a calibração, a instrução da fase no lugar das leituras
+     if (state->flags & (STATE_FLAG_CAL_REST | STATE_FLAG_CAL_SWEEP)) {
+         snprintf(str_x, sizeof(str_x), "CAL   ");
+         snprintf(str_y, sizeof(str_y), (state->flags & STATE_FLAG_CAL_REST) ? "SOLTE " : "GIRE  ");
+     } else {
+         snprintf(str_x, sizeof(str_x), "X:%4u", state->x);
+         snprintf(str_y, sizeof(str_y), "Y:%4u", state->y);
+     }
+     ssd1306_view_draw_string(&readout_view, str_x, 0, 0);
+     ssd1306_view_draw_string(&readout_view, str_y, 64, 0);
+     strip_chart_draw(&history_x, &history_x_view);
+     strip_chart_draw(&history_y, &history_y_view);
+ 
+     // square_x é a linha e square_y a coluna do canto superior esquerdo
+     ssd1306_sprite_show(&screen_view, &cursor, square_y, square_x);
+ }
+ 
+ #if DUAL_CORE
+ /**
+  * Laço do núcleo 1: dono do framebuffer e do I2C
+  * Consome os estados publicados pelo núcleo 0 (fica só com o mais recente),
+  * redesenha e dispara o envio por DMA. Dorme em __wfe até receber um novo
+  * estado (__sev do núcleo 0) ou até a IRQ do DMA liberar o barramento
+  */
+ void core1_entry() {
+     display_state_t state;
+     bool pending = false;
+ 
+     init_display();
+     // Permite que o núcleo 0 pause este núcleo ao gravar a calibração
+     flash_safe_execute_core_init();
+ 
+     while (true) {
+         bool fresh = false;
+         while (spsc_queue_pop(&state_queue, &state)) {
+             fresh = true;
+         }
+ 
+         if (fresh) {
+             TRACE_BEGIN(t_raster);
+             update_display(&state);
+             TRACE_END(TRACE_STAGE_RASTER, t_raster);
+             pending = true;
+         }
+         if (pending) {
+             pending = !flush_display();
+         }
+         if (!fresh) {
+             TRACE_BEGIN(t_sleep);
+             __wfe();
+             TRACE_END(TRACE_STAGE_SLEEP, t_sleep);
+         }
+     }
+ }
+ #endif
+ 
+ /**
+  * Avança a calibração com a saída mais recente dos filtros; ao fim da
+  * varredura passa a usar o perfil medido e deixa a gravação na flash e o
+  * relato para o loop principal (calibrate_finish), fora da amostragem
+  * @param now_us Instante da amostra
+  */
+ void calibrate_step(uint32_t now_us) {
+     joystick_cal_t cal;
+     joystick_cal_result_t result = joystick_cal_feed(&cal_run, filter_x.value, filter_y.value, now_us, &cal);
+     if (result == JOYSTICK_CAL_BUSY) {
+         return;
+     }
+     if (result == JOYSTICK_CAL_OK) {
+         apply_calibration(&cal);
+         cal_profile = cal;
+     }
+     cal_result = result;
+     cal_pending = true;
+ }
+ 
+ /**
+  * Tarefa de amostragem: passa os quadros X/Y acumulados no anel do ADC
+  * desde a última execução pelos filtros
+  */
+ bool task_sample(void *arg) {
+     static uint32_t last_overruns = 0;
+     adc_frame_t frames[64];
+     size_t count;
+ 
+     TRACE_BEGIN(t_adc);
+     while ((count = adc_sampler_read(frames, count_of(frames))) > 0) {
+         for (size_t i = 0; i < count; ++i) {
+             joystick_filter_push(&filter_x, frames[i].x);
+             // Os dois filtros recebem os quadros juntos e decimam no mesmo passo
+             if (joystick_filter_push(&filter_y, frames[i].y)) {
+                 strip_chart_push(&history_x, filter_x.value);
+                 strip_chart_push(&history_y, filter_y.value);
+                 if (cal_run.phase != JOYSTICK_CAL_IDLE) {
+                     calibrate_step((uint32_t)frames[i].timestamp_us);
+                 }
+             }
+             stream_push(&stream, frames[i].x, frames[i].y, (uint32_t)frames[i].timestamp_us);
+         }
+     }
+     uint32_t overruns = adc_sampler_overruns();
+     stream_note_lost(&stream, overruns - last_overruns);
+     last_overruns = overruns;
+     TRACE_END(TRACE_STAGE_ADC, t_adc);
+     return true;
+ }
+ 
+ /**
+  * Grava o perfil da calibração terminada e relata o resultado. O
+  * apagamento do setor para a CPU por dezenas de ms, tempo em que o DMA
+  * continua enchendo o anel do ADC: a amostragem é posta em dia logo em
+  * seguida e os quadros que o anel não segurou entram nas perdas do
+  * streaming e no relato
+  */
+ void calibrate_finish(void) {
+     bool saved = false;
+     uint32_t lost = 0;
+     if (cal_result == JOYSTICK_CAL_OK) {
+         uint32_t overruns = adc_sampler_overruns();
+         saved = joystick_cal_save(&cal_profile);
+         task_sample(NULL);
+         lost = adc_sampler_overruns() - overruns;
+     }
+     // Texto na serial quebraria o streaming binário
+     if (stream.active) {
+         return;
+     }
+     if (cal_result == JOYSTICK_CAL_FAILED) {
+         printf("calibracao: curso insuficiente, perfil mantido\n");
+         return;
+     }
+     const joystick_cal_t *cal = &cal_profile;
+     printf("calibracao: X centro %u [%u, %u] zona %u; Y centro %u [%u, %u] zona %u; %s (%lu quadros perdidos)\n",
+            cal->x.center, cal->x.min, cal->x.max, cal->x.deadzone, cal->y.center, cal->y.min, cal->y.max,
+            cal->y.deadzone, saved ? "gravada" : "falha ao gravar", (unsigned long)lost);
+ }
+ 
+ /**
+  * Tarefa dos botões: retira as bordas enfileiradas pela interrupção e
+  * avança as máquinas de estado (debounce, pressão longa, clique e duplo clique)
+  */
+ bool task_buttons(void *arg) {
+     button_dispatch(buttons, count_of(buttons), time_us_32(), handle_button);
+     return true;
+ }
+ 
+ /**
+  * Tarefa de controle: alvos de brilho dos LEDs a partir das leituras
+  * filtradas. O motor de fades só refaz a tabela quando o alvo muda; os
+  * passos intermediários são aplicados pelo DMA, sem a CPU
+  */
+ bool task_control(void *arg) {
+     TRACE_BEGIN(t_pwm);
+     if (pwm_enabled) {
+         // Zona morta com histerese para que o LED não pisque na borda
+         led_fade_to(&leds, led_red, joystick_map_pwm(&map_x, joystick_filter_gated(&filter_x)), LED_TRACK_FADE_US, LED_EASE_OUT);   // Eixo X controla LED vermelho
+         led_fade_to(&leds, led_blue, joystick_map_pwm(&map_y, joystick_filter_gated(&filter_y)), LED_TRACK_FADE_US, LED_EASE_OUT);  // Eixo Y controla LED azul
+     } else {
+         led_fade_to(&leds, led_red, 0, LED_TOGGLE_FADE_US, LED_EASE_IN_OUT);
+         led_fade_to(&leds, led_blue, 0, LED_TOGGLE_FADE_US, LED_EASE_IN_OUT);
+     }
+     TRACE_END(TRACE_STAGE_PWM, t_pwm);
+     return true;
+ }
+ 
+ /**
+  * Tarefa do display (descartável): no modo de dois núcleos publica o estado
+  * para o núcleo 1; senão desenha e dispara o envio. Retorna false, e o
+  * quadro é descartado, se a fila estiver cheia ou o I2C ainda ocupado
+  */
+ bool task_display(void *arg) {
+     display_state_t state = {
+         .x = filter_x.value,
+         .y = filter_y.value,
+         .pos_x = joystick_map_position(&map_x, filter_x.value),
+         .pos_y = joystick_map_position(&map_y, filter_y.value),
+         .border_style = border_style,
+         .flags = (pwm_enabled ? STATE_FLAG_PWM : 0) | (led_green_state ? STATE_FLAG_GREEN : 0),
+         .history = (uint8_t)strip_chart_head(&history_y),
+     };
+     if (cal_armed || cal_run.phase == JOYSTICK_CAL_SETTLE || cal_run.phase == JOYSTICK_CAL_REST) {
+         state.flags |= STATE_FLAG_CAL_REST;
+     } else if (cal_run.phase == JOYSTICK_CAL_SWEEP) {
+         state.flags |= STATE_FLAG_CAL_SWEEP;
+     }
+ 
+ #if DUAL_CORE
+     // Publica apenas quando algo mudou
+     static display_state_t last_state = { .border_style = 0xFF };
+     if (state.x == last_state.x && state.y == last_state.y &&
+         state.pos_x == last_state.pos_x && state.pos_y == last_state.pos_y &&
+         state.border_style == last_state.border_style && state.flags == last_state.flags &&
+         state.history == last_state.history) {
+         return true;
+     }
+     if (!spsc_queue_push(&state_queue, &state)) {
+         return false;
+     }
+     last_state = state;
+     __sev();
+     return true;
+ #else
+     if (ssd1306_group_busy(&displays)) {
+         return false;
+     }
+     // Atualiza o display (apenas a região alterada)
+     TRACE_BEGIN(t_raster);
+     update_display(&state);
+     TRACE_END(TRACE_STAGE_RASTER, t_raster);
+     return flush_display();
+ #endif
+ }
+ 
+ /**
+  * Tarefa de streaming: entrega à USB apenas o que cabe no buffer de
+  * transmissão, para nunca bloquear o laço; com o host lento os quadros se
+  * acumulam na fila e, com ela cheia, são descartados (saltos na sequência)
+  */
+ bool task_stream(void *arg) {
+     if (!stream.active || !stdio_usb_connected()) {
+         return true;
+     }
+     uint32_t room = tud_cdc_write_available();
+     size_t len = stream_take(&stream, stream_batch, room < sizeof(stream_batch) ? room : sizeof(stream_batch));
+     if (len > 0) {
+         // Direto no driver USB: sem tradução de CRLF e sem passar pela UART
+         stdio_usb.out_chars((const char *)stream_batch, len);
+     }
+     return true;
+ }
+ 
+ /**
+  * Tarefa de diagnóstico: execuções, prazos perdidos e descartes por tarefa
+  */
+ bool task_report(void *arg) {
+     // Texto na serial quebraria o streaming binário
+     if (stream.active) {
+         return true;
+     }
+     sched_report(&scheduler);
+     return true;
+ }
+ 
  int main() {
      // Inicializações
      stdio_init_all();
+ #if TRACE_ENABLED
+     trace_init();
+ #endif
+     button_queue_init();
      init_gpio();
      init_adc();
      init_i2c();
      init_pwm();
+     // Antes do núcleo 1, que desenha os históricos
+     strip_chart_init(&history_x, HISTORY_WIDTH, HISTORY_HEIGHT, 0, 4095, HISTORY_SAMPLES);
+     strip_chart_init(&history_y, HISTORY_WIDTH, HISTORY_HEIGHT, 0, 4095, HISTORY_SAMPLES);
+ #if DUAL_CORE
+     spsc_queue_init(&state_queue, state_storage, sizeof(display_state_t), count_of(state_storage));
+     multicore_launch_core1(core1_entry);
+ #else
      init_display();
+ #endif
  
-     // Variáveis para leitura do ADC
-     uint16_t adc_value_x;
-     uint16_t adc_value_y;
-     char str_x[5];
-     char str_y[5];
+     // Perfil gravado na flash (lido pela XIP, sem cópia) ou o padrão
+     joystick_cal_t cal;
+     bool calibrated = joystick_cal_load(&cal);
+     if (!calibrated) {
+         joystick_cal_default(&cal);
+     }
+     joystick_filter_init(&filter_x, cal.x.center);
+     joystick_filter_init(&filter_y, cal.y.center);
+     apply_calibration(&cal);
+     printf("calibracao: %s\n", calibrated ? "perfil da flash" : "perfil padrao");
+     stream_init(&stream, adc_sampler_frame_rate());
+ 
+     // Tarefas em ordem de prioridade; o display cede a vez (descarta o
+     // quadro e reduz a taxa) para não atrasar amostragem e controle
+     sched_init(&scheduler, time_us_64);
+     sched_add(&scheduler, "sample", SAMPLE_PERIOD_US, task_sample, NULL);
+     sched_add(&scheduler, "control", CONTROL_PERIOD_US, task_control, NULL);
+     sched_add(&scheduler, "buttons", BUTTON_PERIOD_US, task_buttons, NULL);
+     sched_add(&scheduler, "stream", STREAM_PERIOD_US, task_stream, NULL);
+     sched_task_t *display = sched_add(&scheduler, "display", DISPLAY_PERIOD_US, task_display, NULL);
+     sched_set_droppable(display, DISPLAY_MAX_PERIOD_US);
+     sched_add(&scheduler, "report", REPORT_PERIOD_US, task_report, NULL);
  
-     // Loop principal
+     // Loop principal: executa o que venceu e dorme em __wfi até o próximo prazo
      while (true) {
-        adc_select_input(0);
-        adc_value_x = adc_read();
-        adc_select_input(1);
-        adc_value_y = adc_read();
-
-        // Conversão para string dos valores ADC
-        sprintf(str_x, "%d", adc_value_x);
-        sprintf(str_y, "%d", adc_value_y);
-
-        // Controle dos LEDs via PWM
-        if (pwm_enabled) {
-            pwm_set_gpio_level(LED_RED, calculate_pwm(adc_value_x));   // Eixo X controla LED vermelho
-            pwm_set_gpio_level(LED_BLUE, calculate_pwm(adc_value_y));  // Eixo Y controla LED azul
-        } else {
-            pwm_set_gpio_level(LED_RED, 0);
-            pwm_set_gpio_level(LED_BLUE, 0);
-        }
-
-        // Cálculo da posição do quadrado com inversão do eixo X
-        uint8_t square_x = calculate_position(adc_value_x, 64, true);  // Inverte X
-        uint8_t square_y = calculate_position(adc_value_y, 128, false); // Y normal
-
-        // Limpa o display e desenha o layout base
-        ssd1306_fill(&ssd, false);
-
-        // Desenha a borda atual
-        switch (border_style) {
-            case 0:
-                ssd1306_rect(&ssd, 0, 0, WIDTH, HEIGHT, true, false);
-                break;
-            case 1:
-                draw_dotted_rect(&ssd, 0, 0, WIDTH, HEIGHT);
-                break;
-            case 2:
-                draw_double_rect(&ssd, 0, 0, WIDTH, HEIGHT);
-                break;
-        }
-
-        // Desenha o quadrado na posição calculada
-        draw_square(&ssd, square_x, square_y, 8);
-
-        // Atualiza o display
-        ssd1306_send_data(&ssd);
-
-        sleep_ms(20);
-    }
-}
\ No newline at end of file
+         uint64_t next = sched_run(&scheduler);
+ 
+         // Calibração terminada na tarefa de amostragem: a gravação na flash
+         // fica fora dela
+         if (cal_pending) {
+             cal_pending = false;
+             calibrate_finish();
+         }
+ 
+ #if TRACE_ENABLED
+         // Dump pedido pela pressão longa no botão A
+         if (trace_dump_requested) {
+             trace_dump_requested = false;
+             trace_dump();
+         }
+ #endif
+ 
+         TRACE_BEGIN(t_sleep);
+         sched_wait(&scheduler, next);
+         TRACE_END(TRACE_STAGE_SLEEP, t_sleep);
+     }
+ }
@@ -0,0 +1,159 @@
+#include "adc_sampler.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+// O canal de DMA é rearmado a cada bloco; o contador de épocas permite obter o
+// total de amostras escritas sem interromper a CPU a cada volta do anel
+#define ADC_SAMPLER_BLOCK (1u << 30)
+
+// Folga mantida entre leitor e escritor: o quadro em escrita não é lido
+#define ADC_SAMPLER_GUARD 2u
+
+static uint16_t ring[ADC_SAMPLER_RING_SAMPLES] __attribute__((aligned(1 << ADC_SAMPLER_RING_BITS)));
+
+static struct {
+  int dma_channel;
+  uint32_t div_q8;           // divisor do ADC em 1/256 de ciclo (clkdiv + 1)
+  uint32_t frame_rate_hz;
+  uint64_t start_us;
+  volatile uint32_t epoch;
+  uint64_t read_index;       // em amostras, sempre par (início de quadro X/Y)
+  uint32_t overruns;
+} sampler = { .dma_channel = -1 };
+
+static void adc_sampler_dma_irq(void) {
+  if (sampler.dma_channel < 0 || !dma_channel_get_irq1_status(sampler.dma_channel))
+    return;
+  dma_channel_acknowledge_irq1(sampler.dma_channel);
+  // O endereço de escrita continua de onde parou, então a posição no anel
+  // segue sendo o total de amostras módulo o tamanho do anel
+  dma_channel_set_trans_count(sampler.dma_channel, ADC_SAMPLER_BLOCK, true);
+  sampler.epoch++;
+}
+
+// Total de amostras escritas desde adc_sampler_start
+static uint64_t adc_sampler_written(void) {
+  uint32_t epoch, remaining;
+  do {
+    epoch = sampler.epoch;
+    remaining = dma_channel_hw_addr(sampler.dma_channel)->transfer_count;
+  } while (epoch != sampler.epoch);
+  return (uint64_t)epoch * ADC_SAMPLER_BLOCK + (ADC_SAMPLER_BLOCK - remaining);
+}
+
+// Instante da amostragem do quadro n: cada quadro dura 2 conversões de
+// div_q8 / 256 ciclos do clock de 48 MHz do ADC
+static uint64_t adc_sampler_timestamp(uint64_t frame) {
+  return sampler.start_us + frame * 2 * sampler.div_q8 / (48 * 256);
+}
+
+void adc_sampler_init(uint32_t frame_rate_hz) {
+  if (frame_rate_hz == 0)
+    frame_rate_hz = 1;
+  if (frame_rate_hz > ADC_SAMPLER_MAX_FRAME_RATE)
+    frame_rate_hz = ADC_SAMPLER_MAX_FRAME_RATE;
+
+  // Período por conversão em ciclos de 48 MHz; abaixo de 96 o ADC já opera no
+  // máximo, e o hardware usa (clkdiv + 1) com 8 bits de fração
+  uint32_t div_q8 = (uint32_t)((48000000ull * 256) / (2ull * frame_rate_hz));
+  if (div_q8 < 96 * 256)
+    div_q8 = 96 * 256;
+  sampler.div_q8 = div_q8;
+  sampler.frame_rate_hz = (uint32_t)((48000000ull * 256) / (2ull * div_q8));
+
+  adc_select_input(0);
+  adc_set_round_robin((1u << 0) | (1u << 1));
+  adc_fifo_setup(true, true, 1, false, false);
+  adc_set_clkdiv((float)(div_q8 - 256) / 256.0f);
+
+  if (sampler.dma_channel < 0) {
+    sampler.dma_channel = dma_claim_unused_channel(true);
+    dma_channel_set_irq1_enabled(sampler.dma_channel, true);
+    irq_add_shared_handler(DMA_IRQ_1, adc_sampler_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_1, true);
+  }
+}
+
+void adc_sampler_start(void) {
+  adc_run(false);
+  adc_fifo_drain();
+  adc_select_input(0);
+
+  dma_channel_config cfg = dma_channel_get_default_config(sampler.dma_channel);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&cfg, false);
+  channel_config_set_write_increment(&cfg, true);
+  channel_config_set_ring(&cfg, true, ADC_SAMPLER_RING_BITS);
+  channel_config_set_dreq(&cfg, DREQ_ADC);
+  dma_channel_configure(sampler.dma_channel, &cfg, ring, &adc_hw->fifo, ADC_SAMPLER_BLOCK, true);
+
+  sampler.epoch = 0;
+  sampler.read_index = 0;
+  sampler.overruns = 0;
+  sampler.start_us = time_us_64();
+  adc_run(true);
+}
+
+void adc_sampler_stop(void) {
+  adc_run(false);
+  dma_channel_abort(sampler.dma_channel);
+  adc_fifo_drain();
+}
+
+size_t adc_sampler_read(adc_frame_t *out, size_t max) {
+  uint64_t written = adc_sampler_written() & ~1ull;
+  uint64_t limit = ADC_SAMPLER_RING_SAMPLES - ADC_SAMPLER_GUARD;
+
+  if (written - sampler.read_index > limit) {
+    uint64_t skip_to = written - limit;
+    sampler.overruns += (uint32_t)((skip_to - sampler.read_index) / 2);
+    sampler.read_index = skip_to;
+  }
+
+  size_t count = 0;
+  while (count < max && sampler.read_index < written) {
+    uint32_t pos = (uint32_t)(sampler.read_index % ADC_SAMPLER_RING_SAMPLES);
+    out[count].x = ring[pos];
+    out[count].y = ring[pos + 1];
+    out[count].timestamp_us = adc_sampler_timestamp(sampler.read_index / 2);
+    sampler.read_index += 2;
+    count++;
+  }
+
+  // Se o DMA deu a volta durante a cópia, os quadros mais antigos copiados
+  // podem ter sido sobrescritos: descarta-os
+  uint64_t now = adc_sampler_written();
+  uint64_t first = sampler.read_index - 2 * count;
+  if (count && now - first > ADC_SAMPLER_RING_SAMPLES) {
+    size_t lost = (size_t)((now - first - ADC_SAMPLER_RING_SAMPLES + 1) / 2);
+    if (lost > count)
+      lost = count;
+    sampler.overruns += lost;
+    for (size_t i = lost; i < count; ++i)
+      out[i - lost] = out[i];
+    count -= lost;
+  }
+  return count;
+}
+
+bool adc_sampler_latest(adc_frame_t *out) {
+  uint64_t written = adc_sampler_written() & ~1ull;
+  if (written < 2)
+    return false;
+
+  uint64_t index = written - 2;
+  uint32_t pos = (uint32_t)(index % ADC_SAMPLER_RING_SAMPLES);
+  out->x = ring[pos];
+  out->y = ring[pos + 1];
+  out->timestamp_us = adc_sampler_timestamp(index / 2);
+  return true;
+}
+
+uint32_t adc_sampler_frame_rate(void) {
+  return sampler.frame_rate_hz;
+}
+
+uint32_t adc_sampler_overruns(void) {
+  return sampler.overruns;
+}
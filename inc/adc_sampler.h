@@ -0,0 +1,36 @@
+#ifndef ADC_SAMPLER_H
+#define ADC_SAMPLER_H
+
+#include "pico/stdlib.h"
+
+// Anel de amostras preenchido pelo DMA: 2^ADC_SAMPLER_RING_BITS bytes,
+// alinhado ao próprio tamanho (exigência do modo ring do DMA)
+#define ADC_SAMPLER_RING_BITS 10
+#define ADC_SAMPLER_RING_SAMPLES ((1u << ADC_SAMPLER_RING_BITS) / sizeof(uint16_t))
+
+// Taxa máxima de quadros X/Y: o ADC converte a 500 kS/s (96 ciclos de 48 MHz)
+// e alterna entre as duas entradas
+#define ADC_SAMPLER_MAX_FRAME_RATE 250000u
+
+// Um quadro contém a leitura de ADC0 (X) e ADC1 (Y) feitas em sequência
+typedef struct {
+  uint16_t x, y;
+  uint64_t timestamp_us;
+} adc_frame_t;
+
+void adc_sampler_init(uint32_t frame_rate_hz);
+void adc_sampler_start(void);
+void adc_sampler_stop(void);
+
+// Copia para out os quadros ainda não lidos, do mais antigo ao mais novo.
+// Se o DMA ultrapassou o leitor, os quadros perdidos são descartados e
+// contabilizados em adc_sampler_overruns. Deve haver um único leitor.
+size_t adc_sampler_read(adc_frame_t *out, size_t max);
+
+// Último quadro completo, sem consumi-lo; false se ainda não houver nenhum
+bool adc_sampler_latest(adc_frame_t *out);
+
+uint32_t adc_sampler_frame_rate(void);
+uint32_t adc_sampler_overruns(void);
+
+#endif // ADC_SAMPLER_H
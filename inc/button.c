@@ -0,0 +1,94 @@
+#include "button.h"
+#include "spsc_queue.h"
+
+typedef struct {
+  uint32_t time_us;
+  uint8_t gpio;
+  uint8_t events;
+} button_edge_t;
+
+static spsc_queue_t edge_queue;
+static button_edge_t edge_storage[BUTTON_QUEUE_SIZE];
+static volatile uint32_t overflows;
+
+void button_queue_init(void) {
+  spsc_queue_init(&edge_queue, edge_storage, sizeof(button_edge_t), BUTTON_QUEUE_SIZE);
+  overflows = 0;
+}
+
+bool button_queue_edge(uint gpio, uint32_t events) {
+  button_edge_t e = { time_us_32(), gpio, events };
+  if (spsc_queue_push(&edge_queue, &e))
+    return true;
+  overflows++;
+  return false;
+}
+
+uint32_t button_queue_overflows(void) {
+  return overflows;
+}
+
+void button_init(button_t *b, uint pin) {
+  *b = (button_t){ .pin = pin };
+}
+
+static void button_set(button_t *b, bool pressed, uint32_t t, button_handler_t handler) {
+  b->pressed = pressed;
+  b->changed_us = t;
+
+  if (pressed) {
+    b->pressed_us = t;
+    b->long_sent = false;
+    handler(b->pin, BUTTON_PRESS);
+    b->in_double = b->click_armed && t - b->released_us <= BUTTON_DOUBLE_CLICK_US;
+    b->click_armed = false;
+    if (b->in_double)
+      handler(b->pin, BUTTON_DOUBLE_CLICK);
+  } else {
+    b->released_us = t;
+    b->click_armed = !b->long_sent && !b->in_double;
+    handler(b->pin, BUTTON_RELEASE);
+  }
+}
+
+static void button_edge(button_t *b, const button_edge_t *e, button_handler_t handler) {
+  bool fall = e->events & GPIO_IRQ_EDGE_FALL;
+  bool rise = e->events & GPIO_IRQ_EDGE_RISE;
+
+  // As duas bordas juntas, borda repetida ou repique: o nível final é
+  // conferido em button_poll quando o pino se estabiliza
+  if (fall == rise || fall == b->pressed)
+    return;
+  if (e->time_us - b->changed_us < BUTTON_DEBOUNCE_US)
+    return;
+  button_set(b, fall, e->time_us, handler);
+}
+
+static void button_poll(button_t *b, uint32_t now_us, button_handler_t handler) {
+  bool level = !gpio_get(b->pin);
+  if (level != b->pressed && now_us - b->changed_us >= BUTTON_DEBOUNCE_US)
+    button_set(b, level, now_us, handler);
+
+  if (b->pressed && !b->long_sent && now_us - b->pressed_us >= BUTTON_LONG_PRESS_US) {
+    b->long_sent = true;
+    handler(b->pin, BUTTON_LONG_PRESS);
+  }
+  if (b->click_armed && now_us - b->released_us > BUTTON_DOUBLE_CLICK_US) {
+    b->click_armed = false;
+    handler(b->pin, BUTTON_CLICK);
+  }
+}
+
+void button_dispatch(button_t *buttons, size_t count, uint32_t now_us, button_handler_t handler) {
+  button_edge_t e;
+  while (spsc_queue_pop(&edge_queue, &e)) {
+    for (size_t i = 0; i < count; ++i) {
+      if (buttons[i].pin == e.gpio) {
+        button_edge(&buttons[i], &e, handler);
+        break;
+      }
+    }
+  }
+  for (size_t i = 0; i < count; ++i)
+    button_poll(&buttons[i], now_us, handler);
+}
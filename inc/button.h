@@ -0,0 +1,52 @@
+#ifndef BUTTON_H
+#define BUTTON_H
+
+#include "pico/stdlib.h"
+
+// Botões ativos em nível baixo. A IRQ só enfileira a borda com o instante
+// (button_queue_edge); o laço principal retira as bordas e as passa por uma
+// máquina de estados por pino, que faz o debounce e gera os gestos.
+#define BUTTON_DEBOUNCE_US 30000       // bordas mais próximas que isso são repique
+#define BUTTON_LONG_PRESS_US 1000000   // pressão longa
+#define BUTTON_DOUBLE_CLICK_US 350000  // intervalo máximo entre dois cliques
+#define BUTTON_QUEUE_SIZE 32           // potência de 2
+
+// Uma ação ligada a BUTTON_CLICK não precisa ser desfeita pelos outros gestos:
+// o clique só sai depois de a pressão curta terminar sem virar pressão longa e
+// de a janela do duplo clique passar sem uma segunda pressão
+typedef enum {
+  BUTTON_PRESS,
+  BUTTON_RELEASE,
+  BUTTON_LONG_PRESS,     // uma vez por pressão, ainda com o botão pressionado
+  BUTTON_DOUBLE_CLICK,   // na segunda pressão, logo após o BUTTON_PRESS dela
+  BUTTON_CLICK,          // pressão curta isolada, BUTTON_DOUBLE_CLICK_US após soltar
+} button_gesture_t;
+
+typedef void (*button_handler_t)(uint pin, button_gesture_t gesture);
+
+typedef struct {
+  uint8_t pin;
+  bool pressed;          // estado após o debounce
+  bool long_sent;        // BUTTON_LONG_PRESS já emitido nesta pressão
+  bool click_armed;      // última pressão foi curta: clique ou início de duplo clique
+  bool in_double;        // pressão atual completou um duplo clique
+  uint32_t changed_us;   // última transição aceita
+  uint32_t pressed_us;   // início da pressão atual
+  uint32_t released_us;  // fim da última pressão
+} button_t;
+
+void button_queue_init(void);
+
+// Chamado na IRQ de GPIO: enfileira a borda; false se a fila estava cheia (a
+// correção pelo nível do pino em button_dispatch recupera o estado)
+bool button_queue_edge(uint gpio, uint32_t events);
+
+uint32_t button_queue_overflows(void);
+
+void button_init(button_t *b, uint pin);
+
+// Retira as bordas enfileiradas, entrega cada uma ao botão do pino e atualiza
+// as temporizações de todos (pressão longa, janela do duplo clique)
+void button_dispatch(button_t *buttons, size_t count, uint32_t now_us, button_handler_t handler);
+
+#endif // BUTTON_H
@@ -0,0 +1,22 @@
+#ifndef DISPLAY_STATE_H
+#define DISPLAY_STATE_H
+
+#include <stdint.h>
+
+// Estado enviado do laço de controle para o desenho do display
+typedef struct {
+  uint16_t x, y;          // Leituras filtradas dos eixos
+  uint8_t pos_x, pos_y;   // Canto do quadrado (linha, coluna), já calibrado
+  uint8_t border_style;   // Estilo atual da borda
+  uint8_t flags;          // STATE_FLAG_*
+  uint8_t history;        // Colunas fechadas do histórico (mód. 256): publica a cada coluna
+} display_state_t;
+
+#define STATE_FLAG_PWM 0x01    // Controle PWM dos LEDs ativo
+#define STATE_FLAG_GREEN 0x02  // LED verde aceso
+#define STATE_FLAG_CAL_REST 0x04   // Calibração: joystick solto
+#define STATE_FLAG_CAL_SWEEP 0x08  // Calibração: girar até os batentes
+
+#define BORDER_STYLE_COUNT 3
+
+#endif // DISPLAY_STATE_H
@@ -12,6 +12,10 @@
 #define FONT_OFFSET_NUMBERS 1  // 0-9
 #define FONT_OFFSET_UPPERCASE 11 // A-Z
 #define FONT_OFFSET_LOWERCASE 37 // a-z
+#define FONT_OFFSET_SYMBOLS 63   // pontuação ASCII, na ordem de FONT_SYMBOLS
+
+// Caracteres de pontuação presentes na fonte, na ordem em que aparecem no array
+#define FONT_SYMBOLS "!\"#$%&'()*+,-./:;<=>?@[\\]^_`{|}~"
 
 // Array de fontes 8x8
 static const uint8_t font[] = {
@@ -78,6 +82,39 @@ static const uint8_t font[] = {
 0x44, 0x28, 0x10, 0x28, 0x44, 0x00, 0x00, 0x00, //x
 0x0C, 0x50, 0x50, 0x50, 0x3C, 0x00, 0x00, 0x00, //y
 0x44, 0x64, 0x54, 0x4C, 0x44, 0x00, 0x00, 0x00, //z
+// Símbolos, na ordem de FONT_SYMBOLS
+0x00, 0x00, 0x5F, 0x00, 0x00, 0x00, 0x00, 0x00, //!
+0x00, 0x07, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, //"
+0x14, 0x7F, 0x14, 0x7F, 0x14, 0x00, 0x00, 0x00, //#
+0x24, 0x2A, 0x7F, 0x2A, 0x12, 0x00, 0x00, 0x00, //$
+0x23, 0x13, 0x08, 0x64, 0x62, 0x00, 0x00, 0x00, //%
+0x36, 0x49, 0x55, 0x22, 0x50, 0x00, 0x00, 0x00, //&
+0x00, 0x05, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, //'
+0x00, 0x1C, 0x22, 0x41, 0x00, 0x00, 0x00, 0x00, //(
+0x00, 0x41, 0x22, 0x1C, 0x00, 0x00, 0x00, 0x00, //)
+0x08, 0x2A, 0x1C, 0x2A, 0x08, 0x00, 0x00, 0x00, //*
+0x08, 0x08, 0x3E, 0x08, 0x08, 0x00, 0x00, 0x00, //+
+0x00, 0x50, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, //,
+0x08, 0x08, 0x08, 0x08, 0x08, 0x00, 0x00, 0x00, //-
+0x00, 0x60, 0x60, 0x00, 0x00, 0x00, 0x00, 0x00, //.
+0x20, 0x10, 0x08, 0x04, 0x02, 0x00, 0x00, 0x00, ///
+0x00, 0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, //:
+0x00, 0x56, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, //;
+0x08, 0x14, 0x22, 0x41, 0x00, 0x00, 0x00, 0x00, //<
+0x14, 0x14, 0x14, 0x14, 0x14, 0x00, 0x00, 0x00, //=
+0x00, 0x41, 0x22, 0x14, 0x08, 0x00, 0x00, 0x00, //>
+0x02, 0x01, 0x51, 0x09, 0x06, 0x00, 0x00, 0x00, //?
+0x32, 0x49, 0x79, 0x41, 0x3E, 0x00, 0x00, 0x00, //@
+0x00, 0x7F, 0x41, 0x41, 0x00, 0x00, 0x00, 0x00, //[
+0x02, 0x04, 0x08, 0x10, 0x20, 0x00, 0x00, 0x00, //\ (barra invertida)
+0x00, 0x41, 0x41, 0x7F, 0x00, 0x00, 0x00, 0x00, //]
+0x04, 0x02, 0x01, 0x02, 0x04, 0x00, 0x00, 0x00, //^
+0x40, 0x40, 0x40, 0x40, 0x40, 0x00, 0x00, 0x00, //_
+0x00, 0x01, 0x02, 0x04, 0x00, 0x00, 0x00, 0x00, //`
+0x00, 0x08, 0x36, 0x41, 0x00, 0x00, 0x00, 0x00, //{
+0x00, 0x00, 0x7F, 0x00, 0x00, 0x00, 0x00, 0x00, //|
+0x00, 0x41, 0x36, 0x08, 0x00, 0x00, 0x00, 0x00, //}
+0x08, 0x04, 0x08, 0x10, 0x08, 0x00, 0x00, 0x00, //~
 
 };
 
@@ -97,6 +134,15 @@ static inline uint8_t* get_char_data(char c) {
     else if (c >= 'a' && c <= 'z') {
         index = FONT_OFFSET_LOWERCASE + (c - 'a');
     }
+    else {
+        const char *symbols = FONT_SYMBOLS;
+        for (int i = 0; symbols[i]; ++i) {
+            if (symbols[i] == c) {
+                index = FONT_OFFSET_SYMBOLS + i;
+                break;
+            }
+        }
+    }
     
     return (uint8_t*)&font[index * FONT_HEIGHT];
 }
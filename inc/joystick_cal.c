@@ -0,0 +1,240 @@
+#include "joystick_cal.h"
+#include "joystick_filter.h"
+#include "joystick_lut.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include <string.h>
+
+// Último setor da flash, fora da área do programa; lido pela XIP
+#define JOYSTICK_CAL_FLASH_OFFSET (PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE)
+#define JOYSTICK_CAL_SLOTS (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define JOYSTICK_CAL_FLASH_TIMEOUT_MS 100
+
+// Nível linear máximo antes da gama
+#define LEVEL_MAX 4095u
+
+_Static_assert(sizeof(joystick_cal_record_t) <= FLASH_PAGE_SIZE, "registro maior que uma página");
+
+static const joystick_cal_record_t *slot_record(uint32_t slot) {
+  return (const joystick_cal_record_t *)(XIP_BASE + JOYSTICK_CAL_FLASH_OFFSET + slot * FLASH_PAGE_SIZE);
+}
+
+static bool slot_erased(uint32_t slot) {
+  const uint32_t *word = (const uint32_t *)slot_record(slot);
+  for (uint32_t i = 0; i < FLASH_PAGE_SIZE / sizeof(uint32_t); ++i)
+    if (word[i] != 0xFFFFFFFFu)
+      return false;
+  return true;
+}
+
+static bool record_valid(const joystick_cal_record_t *r) {
+  return r->magic == JOYSTICK_CAL_MAGIC && r->version == JOYSTICK_CAL_VERSION && r->size == sizeof(*r) &&
+         r->crc == joystick_cal_crc32(r, offsetof(joystick_cal_record_t, crc));
+}
+
+uint32_t joystick_cal_crc32(const void *data, size_t len) {
+  const uint8_t *p = data;
+  uint32_t crc = 0xFFFFFFFFu;
+  while (len--) {
+    crc ^= *p++;
+    for (int bit = 0; bit < 8; ++bit)
+      crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+  }
+  return ~crc;
+}
+
+void joystick_cal_default(joystick_cal_t *cal) {
+  cal->x = (joystick_cal_axis_t){ JOYSTICK_CENTER_X, 0, 4095, JOYSTICK_DEADZONE };
+  cal->y = (joystick_cal_axis_t){ JOYSTICK_CENTER_Y, 0, 4095, JOYSTICK_DEADZONE };
+}
+
+bool joystick_cal_load(joystick_cal_t *cal) {
+  const joystick_cal_record_t *latest = NULL;
+  for (uint32_t slot = 0; slot < JOYSTICK_CAL_SLOTS && !slot_erased(slot); ++slot) {
+    // Registros inválidos (gravação interrompida, outra versão) são pulados
+    if (record_valid(slot_record(slot)))
+      latest = slot_record(slot);
+  }
+  if (!latest)
+    return false;
+  *cal = latest->cal;
+  return true;
+}
+
+typedef struct {
+  uint32_t slot;
+  bool erase;
+  const uint8_t *page;
+} flash_job_t;
+
+// Executada com o outro núcleo e as interrupções em pausa; as rotinas de
+// flash do SDK rodam da RAM e religam a XIP ao terminar
+static void program_slot(void *arg) {
+  const flash_job_t *job = arg;
+  if (job->erase)
+    flash_range_erase(JOYSTICK_CAL_FLASH_OFFSET, FLASH_SECTOR_SIZE);
+  flash_range_program(JOYSTICK_CAL_FLASH_OFFSET + job->slot * FLASH_PAGE_SIZE, job->page, FLASH_PAGE_SIZE);
+}
+
+bool joystick_cal_save(const joystick_cal_t *cal) {
+  static uint8_t page[FLASH_PAGE_SIZE] __attribute__((aligned(4)));
+  joystick_cal_record_t record = {
+    .magic = JOYSTICK_CAL_MAGIC,
+    .version = JOYSTICK_CAL_VERSION,
+    .size = sizeof(record),
+    .cal = *cal,
+  };
+  record.crc = joystick_cal_crc32(&record, offsetof(joystick_cal_record_t, crc));
+  memset(page, 0xFF, sizeof(page));
+  memcpy(page, &record, sizeof(record));
+
+  // Acrescenta na primeira página livre; com o setor cheio, apaga e recomeça
+  flash_job_t job = { .slot = 0, .erase = true, .page = page };
+  for (uint32_t slot = 0; slot < JOYSTICK_CAL_SLOTS; ++slot) {
+    if (slot_erased(slot)) {
+      job.slot = slot;
+      job.erase = false;
+      break;
+    }
+  }
+  if (flash_safe_execute(program_slot, &job, JOYSTICK_CAL_FLASH_TIMEOUT_MS) != PICO_OK)
+    return false;
+  return memcmp(slot_record(job.slot), &record, sizeof(record)) == 0;
+}
+
+static void reset_stats(joystick_cal_run_t *run, joystick_cal_phase_t phase, uint32_t now_us) {
+  run->phase = phase;
+  run->phase_start_us = now_us;
+  run->count = 0;
+  for (int i = 0; i < 2; ++i) {
+    run->sum[i] = 0;
+    run->sum_sq[i] = 0;
+    run->lo[i] = 0xFFFF;
+    run->hi[i] = 0;
+  }
+}
+
+static uint32_t isqrt(uint64_t v) {
+  uint64_t r = 0;
+  for (uint64_t bit = 1ull << 62; bit; bit >>= 2) {
+    if (v >= r + bit) {
+      v -= r + bit;
+      r = (r >> 1) + bit;
+    } else {
+      r >>= 1;
+    }
+  }
+  return (uint32_t)r;
+}
+
+void joystick_cal_begin(joystick_cal_run_t *run, uint32_t now_us) {
+  reset_stats(run, JOYSTICK_CAL_SETTLE, now_us);
+}
+
+joystick_cal_result_t joystick_cal_feed(joystick_cal_run_t *run, uint16_t x, uint16_t y, uint32_t now_us,
+                                        joystick_cal_t *out) {
+  const uint16_t v[2] = { x, y };
+  uint32_t elapsed = now_us - run->phase_start_us;
+
+  if (run->phase == JOYSTICK_CAL_IDLE)
+    return JOYSTICK_CAL_FAILED;
+  if (run->phase == JOYSTICK_CAL_SETTLE) {
+    if (elapsed >= JOYSTICK_CAL_SETTLE_US)
+      reset_stats(run, JOYSTICK_CAL_REST, now_us);
+    return JOYSTICK_CAL_BUSY;
+  }
+
+  run->count++;
+  for (int i = 0; i < 2; ++i) {
+    run->sum[i] += v[i];
+    run->sum_sq[i] += (uint32_t)v[i] * v[i];
+    if (v[i] < run->lo[i])
+      run->lo[i] = v[i];
+    if (v[i] > run->hi[i])
+      run->hi[i] = v[i];
+  }
+
+  if (run->phase == JOYSTICK_CAL_REST) {
+    if (elapsed < JOYSTICK_CAL_REST_US)
+      return JOYSTICK_CAL_BUSY;
+    // Centro = média; ruído = maior desvio visto ou 4 sigma, o que for maior
+    for (int i = 0; i < 2; ++i) {
+      uint64_t n = run->count;
+      uint32_t mean = (uint32_t)((run->sum[i] + n / 2) / n);
+      uint64_t var = (run->sum_sq[i] * n - (uint64_t)run->sum[i] * run->sum[i]) / (n * n);
+      uint32_t noise = 4 * isqrt(var);
+      uint32_t peak = run->hi[i] - mean > mean - run->lo[i] ? run->hi[i] - mean : mean - run->lo[i];
+      if (peak > noise)
+        noise = peak;
+      uint32_t deadzone = noise + JOYSTICK_HYSTERESIS + JOYSTICK_CAL_MARGIN;
+      run->center[i] = mean;
+      run->deadzone[i] = deadzone < JOYSTICK_CAL_MIN_DEADZONE ? JOYSTICK_CAL_MIN_DEADZONE : deadzone;
+    }
+    reset_stats(run, JOYSTICK_CAL_SWEEP, now_us);
+    return JOYSTICK_CAL_BUSY;
+  }
+
+  if (elapsed < JOYSTICK_CAL_SWEEP_US)
+    return JOYSTICK_CAL_BUSY;
+  run->phase = JOYSTICK_CAL_IDLE;
+
+  joystick_cal_axis_t axis[2];
+  for (int i = 0; i < 2; ++i) {
+    axis[i] = (joystick_cal_axis_t){ run->center[i], run->lo[i], run->hi[i], run->deadzone[i] };
+    if (axis[i].center < axis[i].min + axis[i].deadzone + JOYSTICK_CAL_MIN_SPAN ||
+        axis[i].max < axis[i].center + axis[i].deadzone + JOYSTICK_CAL_MIN_SPAN)
+      return JOYSTICK_CAL_FAILED;
+  }
+  out->x = axis[0];
+  out->y = axis[1];
+  return JOYSTICK_CAL_OK;
+}
+
+// Divisão arredondada para cima: o fim de curso atinge o máximo exato
+static uint32_t div_up(uint32_t num, uint32_t den) {
+  return (num + den - 1) / den;
+}
+
+void joystick_map_init(joystick_map_t *map, const joystick_cal_axis_t *axis, uint8_t pos_limit, bool invert) {
+  // O curso de cada lado, a partir da distância em que a zona morta do filtro
+  // volta a fechar, cobre todo o nível; do lado de cima conta também o próprio
+  // máximo. Enquanto a zona morta está aberta nenhuma leitura cai em 0, então
+  // o ruído na borda não apaga e acende o LED
+  uint16_t release = axis->deadzone > JOYSTICK_HYSTERESIS ? axis->deadzone - JOYSTICK_HYSTERESIS : 0;
+  int32_t span_lo = (int32_t)axis->center - axis->min - release;
+  int32_t span_hi = (int32_t)axis->max + 1 - axis->center - release;
+  map->center = axis->center;
+  map->release = release;
+  map->scale_lo = div_up(LEVEL_MAX << 20, span_lo > 1 ? span_lo : 1);
+  map->scale_hi = div_up(LEVEL_MAX << 20, span_hi > 1 ? span_hi : 1);
+
+  map->min = axis->min;
+  map->max = axis->max > axis->min ? axis->max : axis->min + 1;
+  map->pos_scale = div_up((uint32_t)(pos_limit - 8) << 24, map->max - map->min);
+  map->invert = invert;
+}
+
+uint16_t joystick_map_pwm(const joystick_map_t *map, uint16_t value) {
+  // Dentro do curso calibrado o produto abaixo cabe em 32 bits
+  if (value < map->min)
+    value = map->min;
+  if (value > map->max)
+    value = map->max;
+  int32_t diff = (int32_t)value - map->center;
+  uint32_t scale = diff < 0 ? map->scale_lo : map->scale_hi;
+  if (diff < 0)
+    diff = -diff;
+  if (diff < map->release)
+    return 0;
+  uint32_t level = ((uint32_t)(diff - map->release) * scale) >> 20;
+  return lut_gamma[level > LEVEL_MAX ? LEVEL_MAX : level];
+}
+
+uint8_t joystick_map_position(const joystick_map_t *map, uint16_t value) {
+  if (value < map->min)
+    value = map->min;
+  if (value > map->max)
+    value = map->max;
+  uint32_t offset = map->invert ? map->max - value : value - map->min;
+  return (uint8_t)((offset * map->pos_scale) >> 24);
+}
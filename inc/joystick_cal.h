@@ -0,0 +1,109 @@
+#ifndef JOYSTICK_CAL_H
+#define JOYSTICK_CAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// Calibração do joystick: centro, fins de curso e zona morta por eixo, medidos
+// por uma rotina em duas fases e gravados em um setor reservado da flash.
+// Na inicialização o registro mais recente e válido é lido direto da XIP (sem
+// copiar o setor) e convertido em coeficientes de mapeamento; sem registro
+// válido vale o perfil padrão do CMake (JOYSTICK_CENTER_X/Y, JOYSTICK_DEADZONE).
+
+// Fases da rotina, medidas sobre a saída do filtro (250 Hz)
+#define JOYSTICK_CAL_SETTLE_US 300000     // espera após soltar o botão
+#define JOYSTICK_CAL_REST_US 1000000      // repouso: centro e ruído
+#define JOYSTICK_CAL_SWEEP_US 5000000     // varredura: fins de curso
+
+// Zona morta = max(pico do ruído, 4 desvios-padrão) + histerese do filtro +
+// folga para o centro mecânico, que não volta sempre ao mesmo ponto
+#define JOYSTICK_CAL_MARGIN 32
+#define JOYSTICK_CAL_MIN_DEADZONE 48
+
+// Curso mínimo de cada lado do centro, além da zona morta, para aceitar o perfil
+#define JOYSTICK_CAL_MIN_SPAN 1024
+
+// Registro na flash: um por página, acrescentados em sequência até encher o
+// setor (só então ele é apagado), então o mais recente é o último válido
+#define JOYSTICK_CAL_MAGIC 0x4C41434Au    // "JCAL"
+#define JOYSTICK_CAL_VERSION 1
+
+typedef struct {
+  uint16_t center, min, max, deadzone;
+} joystick_cal_axis_t;
+
+typedef struct {
+  joystick_cal_axis_t x, y;
+} joystick_cal_t;
+
+typedef struct {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;          // sizeof(joystick_cal_record_t)
+  joystick_cal_t cal;
+  uint32_t crc;           // CRC-32 dos campos anteriores
+} joystick_cal_record_t;
+
+typedef enum {
+  JOYSTICK_CAL_IDLE,
+  JOYSTICK_CAL_SETTLE,
+  JOYSTICK_CAL_REST,
+  JOYSTICK_CAL_SWEEP,
+} joystick_cal_phase_t;
+
+typedef enum {
+  JOYSTICK_CAL_BUSY,
+  JOYSTICK_CAL_OK,
+  JOYSTICK_CAL_FAILED,    // curso ou ruído fora dos limites; perfil mantido
+} joystick_cal_result_t;
+
+// Estado da rotina em andamento
+typedef struct {
+  joystick_cal_phase_t phase;
+  uint32_t phase_start_us;
+  uint32_t count;
+  uint32_t sum[2];
+  uint64_t sum_sq[2];
+  uint16_t lo[2], hi[2];
+  uint16_t center[2], deadzone[2];   // resultado do repouso
+} joystick_cal_run_t;
+
+// Coeficientes do caminho quente, derivados de um eixo do perfil
+typedef struct {
+  uint16_t center;
+  uint16_t release;              // distância em que a zona morta do filtro volta a fechar
+  uint32_t scale_lo, scale_hi;   // Q20: nível linear por contagem além de release
+  uint16_t min, max;
+  uint32_t pos_scale;            // Q24: pixels por contagem do curso
+  bool invert;
+} joystick_map_t;
+
+// Perfil padrão, usado sem registro válido na flash
+void joystick_cal_default(joystick_cal_t *cal);
+
+// Lê o registro mais recente; false se não houver registro válido desta versão
+bool joystick_cal_load(joystick_cal_t *cal);
+
+// Acrescenta o perfil ao setor (apagando-o se estiver cheio). Pausa o outro
+// núcleo e as interrupções durante a escrita
+bool joystick_cal_save(const joystick_cal_t *cal);
+
+uint32_t joystick_cal_crc32(const void *data, size_t len);
+
+void joystick_cal_begin(joystick_cal_run_t *run, uint32_t now_us);
+
+// Entrega uma saída do filtro (x, y); ao fim da varredura preenche out
+joystick_cal_result_t joystick_cal_feed(joystick_cal_run_t *run, uint16_t x, uint16_t y, uint32_t now_us,
+                                        joystick_cal_t *out);
+
+// pos_limit é o tamanho da tela no eixo; o quadrado de 8 px cabe inteiro
+void joystick_map_init(joystick_map_t *map, const joystick_cal_axis_t *axis, uint8_t pos_limit, bool invert);
+
+// Nível PWM (com gama) para a saída de joystick_filter_gated: a zona morta, com
+// histerese, é a do filtro, e a rampa parte da distância em que ela fecha
+uint16_t joystick_map_pwm(const joystick_map_t *map, uint16_t value);
+// Posição do quadrado para uma leitura filtrada
+uint8_t joystick_map_position(const joystick_map_t *map, uint16_t value);
+
+#endif // JOYSTICK_CAL_H
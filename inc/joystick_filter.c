@@ -0,0 +1,73 @@
+#include "joystick_filter.h"
+
+#define OVERSAMPLE_COUNT (1u << (2 * JOYSTICK_OVERSAMPLE_BITS))
+
+void joystick_filter_init(joystick_filter_t *f, uint16_t center) {
+  uint16_t hires = center << JOYSTICK_OVERSAMPLE_BITS;
+
+  f->acc = 0;
+  f->acc_count = 0;
+#if JOYSTICK_FILTER == JOYSTICK_FILTER_IIR
+  f->iir = (uint32_t)hires << JOYSTICK_IIR_SHIFT;
+#elif JOYSTICK_FILTER == JOYSTICK_FILTER_MOVING_AVG
+  for (uint32_t i = 0; i < (1u << JOYSTICK_MA_BITS); ++i)
+    f->window[i] = hires;
+  f->sum = (uint32_t)hires << JOYSTICK_MA_BITS;
+  f->pos = 0;
+#endif
+  f->hires = hires;
+  f->value = center;
+  f->center = center;
+  f->deadzone = JOYSTICK_DEADZONE;
+  f->active = false;
+}
+
+void joystick_filter_set_zone(joystick_filter_t *f, uint16_t center, uint16_t deadzone) {
+  f->center = center;
+  f->deadzone = deadzone;
+}
+
+bool joystick_filter_push(joystick_filter_t *f, uint16_t sample) {
+  f->acc += sample;
+  if (++f->acc_count < OVERSAMPLE_COUNT)
+    return false;
+
+  // A soma de 4^N amostras tem 12 + 2N bits; descartar N deles deixa N bits
+  // a mais de resolução, já que o ruído não correlacionado se cancela
+  uint16_t x = f->acc >> JOYSTICK_OVERSAMPLE_BITS;
+  f->acc = 0;
+  f->acc_count = 0;
+
+#if JOYSTICK_FILTER == JOYSTICK_FILTER_IIR
+  f->iir = f->iir - (f->iir >> JOYSTICK_IIR_SHIFT) + x;
+  f->hires = f->iir >> JOYSTICK_IIR_SHIFT;
+#elif JOYSTICK_FILTER == JOYSTICK_FILTER_MOVING_AVG
+  f->sum += x - f->window[f->pos];
+  f->window[f->pos] = x;
+  f->pos = (f->pos + 1) & ((1u << JOYSTICK_MA_BITS) - 1);
+  f->hires = f->sum >> JOYSTICK_MA_BITS;
+#else
+  f->hires = x;
+#endif
+
+#if JOYSTICK_OVERSAMPLE_BITS > 0
+  uint32_t rounded = (f->hires + (1u << (JOYSTICK_OVERSAMPLE_BITS - 1))) >> JOYSTICK_OVERSAMPLE_BITS;
+  f->value = rounded > 4095 ? 4095 : rounded;
+#else
+  f->value = f->hires;
+#endif
+  return true;
+}
+
+uint16_t joystick_filter_gated(joystick_filter_t *f) {
+  int32_t dist = (int32_t)f->value - f->center;
+  if (dist < 0)
+    dist = -dist;
+
+  if (f->active && dist < (int32_t)f->deadzone - JOYSTICK_HYSTERESIS)
+    f->active = false;
+  else if (!f->active && dist > (int32_t)f->deadzone + JOYSTICK_HYSTERESIS)
+    f->active = true;
+
+  return f->active ? f->value : f->center;
+}
@@ -0,0 +1,85 @@
+#ifndef JOYSTICK_FILTER_H
+#define JOYSTICK_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Filtros disponíveis; a escolha é feita em tempo de compilação e apenas o
+// código e o estado do filtro selecionado entram no binário
+#define JOYSTICK_FILTER_NONE 0
+#define JOYSTICK_FILTER_IIR 1
+#define JOYSTICK_FILTER_MOVING_AVG 2
+
+#ifndef JOYSTICK_FILTER
+#define JOYSTICK_FILTER JOYSTICK_FILTER_IIR
+#endif
+
+// Sobreamostragem e decimação: 4^N amostras por saída, N bits efetivos extras
+#ifndef JOYSTICK_OVERSAMPLE_BITS
+#define JOYSTICK_OVERSAMPLE_BITS 2
+#endif
+
+// IIR de um polo: y += (x - y) / 2^SHIFT
+#ifndef JOYSTICK_IIR_SHIFT
+#define JOYSTICK_IIR_SHIFT 2
+#endif
+
+// Média móvel de 2^BITS saídas decimadas
+#ifndef JOYSTICK_MA_BITS
+#define JOYSTICK_MA_BITS 3
+#endif
+
+// Centro nominal, zona morta e histerese em torno da borda da zona morta,
+// todos em contagens de 12 bits. Os centros calibrados de cada eixo vêm do
+// CMake (JOYSTICK_CENTER_X/Y), junto com as tabelas de mapeamento
+#ifndef JOYSTICK_CENTER
+#define JOYSTICK_CENTER 2048
+#endif
+#ifndef JOYSTICK_CENTER_X
+#define JOYSTICK_CENTER_X JOYSTICK_CENTER
+#endif
+#ifndef JOYSTICK_CENTER_Y
+#define JOYSTICK_CENTER_Y JOYSTICK_CENTER
+#endif
+#ifndef JOYSTICK_DEADZONE
+#define JOYSTICK_DEADZONE 210
+#endif
+#ifndef JOYSTICK_HYSTERESIS
+#define JOYSTICK_HYSTERESIS 24
+#endif
+
+#define JOYSTICK_HIRES_BITS (12 + JOYSTICK_OVERSAMPLE_BITS)
+
+typedef struct {
+  uint32_t acc;
+  uint16_t acc_count;
+#if JOYSTICK_FILTER == JOYSTICK_FILTER_IIR
+  uint32_t iir;
+#elif JOYSTICK_FILTER == JOYSTICK_FILTER_MOVING_AVG
+  uint16_t window[1 << JOYSTICK_MA_BITS];
+  uint32_t sum;
+  uint8_t pos;
+#endif
+  uint16_t hires;   // saída filtrada com JOYSTICK_HIRES_BITS bits
+  uint16_t value;   // saída filtrada em 12 bits
+  uint16_t center;  // centro do eixo usado pela zona morta
+  uint16_t deadzone;
+  bool active;      // fora da zona morta, com histerese
+} joystick_filter_t;
+
+// Inicia o filtro em repouso no centro informado (calibrado por eixo)
+void joystick_filter_init(joystick_filter_t *f, uint16_t center);
+
+// Troca o centro e a zona morta (perfil de calibração), mantendo o filtro
+void joystick_filter_set_zone(joystick_filter_t *f, uint16_t center, uint16_t deadzone);
+
+// Acumula uma amostra de 12 bits; retorna true quando uma nova saída decimada
+// e filtrada está disponível
+bool joystick_filter_push(joystick_filter_t *f, uint16_t sample);
+
+// Saída filtrada com a zona morta aplicada: dentro dela retorna o centro do eixo. A
+// saída só deixa a zona morta além de deadzone + HYSTERESIS e só volta a ela
+// abaixo de deadzone - HYSTERESIS, evitando oscilação na borda
+uint16_t joystick_filter_gated(joystick_filter_t *f);
+
+#endif // JOYSTICK_FILTER_H
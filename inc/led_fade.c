@@ -0,0 +1,118 @@
+#include "led_fade.h"
+#include "hardware/pwm.h"
+
+void led_fade_init(led_fade_t *fade) {
+  fade->slice_count = 0;
+  fade->channel_count = 0;
+}
+
+int led_fade_add(led_fade_t *fade, uint gpio) {
+  if (fade->channel_count >= LED_FADE_MAX_CHANNELS)
+    return -1;
+
+  uint slice = pwm_gpio_to_slice_num(gpio);
+  uint8_t slot = 0;
+  while (slot < fade->slice_count && fade->slices[slot].slice != slice)
+    slot++;
+  if (slot == fade->slice_count) {
+    if (slot >= LED_FADE_MAX_SLICES)
+      return -1;
+    led_fade_slice_t *s = &fade->slices[slot];
+    s->slice = slice;
+    s->cc = 0;
+    s->count = 0;
+    fade->slice_count++;
+    pwm_set_wrap(slice, LED_FADE_WRAP);
+    led_fade_hw_init(slice);
+    pwm_set_enabled(slice, true);
+  }
+  gpio_set_function(gpio, GPIO_FUNC_PWM);
+
+  led_fade_channel_t *ch = &fade->channels[fade->channel_count];
+  ch->gpio = gpio;
+  ch->slot = slot;
+  ch->shift = pwm_gpio_to_channel(gpio) == PWM_CHAN_B ? 16 : 0;
+  ch->from = ch->to = 0;
+  ch->elapsed = ch->steps = 0;
+  ch->ease = LED_EASE_LINEAR;
+  return fade->channel_count++;
+}
+
+uint16_t led_fade_ease(uint16_t from, uint16_t to, uint32_t step, uint32_t steps, led_ease_t ease) {
+  if (step >= steps)
+    return to;
+
+  // Progresso e curva em Q16
+  uint64_t t = ((uint64_t)step << 16) / steps;
+  uint64_t e;
+  switch (ease) {
+  case LED_EASE_IN:
+    e = (t * t) >> 16;
+    break;
+  case LED_EASE_OUT:
+    e = 65536 - (((65536 - t) * (65536 - t)) >> 16);
+    break;
+  case LED_EASE_IN_OUT:
+    e = (t * t * (3 * 65536 - 2 * t)) >> 32;
+    break;
+  default:
+    e = t;
+    break;
+  }
+  return (uint16_t)(from + ((int32_t)to - from) * (int32_t)e / 65536);
+}
+
+bool led_fade_to(led_fade_t *fade, int channel, uint16_t level, uint32_t duration_us, led_ease_t ease) {
+  if (channel < 0 || channel >= fade->channel_count)
+    return false;
+  if (level > LED_FADE_WRAP)
+    level = LED_FADE_WRAP;
+  led_fade_channel_t *target = &fade->channels[channel];
+  if (target->to == level)
+    return false;
+
+  // Para o DMA e descobre até onde a tabela foi: a palavra em vigor é o ponto
+  // de partida do novo fade, e os demais canais do slice seguem de onde estão
+  led_fade_slice_t *s = &fade->slices[target->slot];
+  size_t done = s->count ? led_fade_hw_stop(s->slice) : 0;
+  if (done > 0)
+    s->cc = s->table[done - 1];
+  for (uint8_t i = 0; i < fade->channel_count; ++i) {
+    led_fade_channel_t *ch = &fade->channels[i];
+    if (ch->slot == target->slot)
+      ch->elapsed = ch->elapsed + done < ch->steps ? ch->elapsed + done : ch->steps;
+  }
+
+  uint32_t steps = (uint32_t)((uint64_t)duration_us * LED_FADE_STEP_HZ / 1000000);
+  if (steps < 1)
+    steps = 1;
+  if (steps > LED_FADE_MAX_STEPS)
+    steps = LED_FADE_MAX_STEPS;
+  target->from = (s->cc >> target->shift) & 0xFFFF;
+  target->to = level;
+  target->elapsed = 0;
+  target->steps = (uint16_t)steps;
+  target->ease = ease;
+
+  // A tabela vai até o fim do fade mais longo em curso no slice
+  size_t count = 0;
+  for (uint8_t i = 0; i < fade->channel_count; ++i) {
+    const led_fade_channel_t *ch = &fade->channels[i];
+    if (ch->slot == target->slot && (size_t)(ch->steps - ch->elapsed) > count)
+      count = ch->steps - ch->elapsed;
+  }
+  for (size_t n = 0; n < count; ++n) {
+    uint32_t word = s->cc;
+    for (uint8_t i = 0; i < fade->channel_count; ++i) {
+      const led_fade_channel_t *ch = &fade->channels[i];
+      if (ch->slot != target->slot)
+        continue;
+      uint16_t value = led_fade_ease(ch->from, ch->to, ch->elapsed + n + 1, ch->steps, ch->ease);
+      word = (word & ~(0xFFFFu << ch->shift)) | (uint32_t)value << ch->shift;
+    }
+    s->table[n] = word;
+  }
+  s->count = count;
+  led_fade_hw_start(s->slice, s->table, count);
+  return true;
+}
@@ -0,0 +1,66 @@
+#ifndef LED_FADE_H
+#define LED_FADE_H
+
+#include "pico/stdlib.h"
+
+// Motor de fades dos LEDs: cada slice de PWM recebe uma tabela de palavras de
+// comparação (canal A nos 16 bits baixos, B nos altos), que o DMA copia para o
+// registrador CC a cada wrap do contador, um passo por período do PWM. A CPU
+// só trabalha ao mudar um alvo: recalcula a tabela do slice a partir do nível
+// em vigor e reinicia o DMA; no fim da tabela o último nível permanece.
+
+#define LED_FADE_WRAP 4095         // resolução do PWM (12 bits, como o ADC)
+#define LED_FADE_STEP_HZ 1000      // frequência do PWM = passos por segundo
+#define LED_FADE_MAX_STEPS 1024    // fade mais longo (~1 s); além disso é truncado
+#define LED_FADE_MAX_SLICES 2
+#define LED_FADE_MAX_CHANNELS 4
+
+typedef enum {
+  LED_EASE_LINEAR,
+  LED_EASE_IN,        // quadrática, começa devagar
+  LED_EASE_OUT,       // quadrática, termina devagar
+  LED_EASE_IN_OUT,    // smoothstep
+} led_ease_t;
+
+typedef struct {
+  uint gpio;
+  uint8_t slot;               // índice do slice em led_fade_t
+  uint8_t shift;              // 0 (canal A) ou 16 (canal B) na palavra CC
+  uint16_t from, to;          // níveis de início e fim do fade
+  uint16_t elapsed, steps;    // passos já aplicados e duração total
+  led_ease_t ease;
+} led_fade_channel_t;
+
+typedef struct {
+  uint slice;
+  uint32_t cc;                // palavra em vigor antes da tabela atual
+  size_t count;               // entradas da tabela em curso (0 = parado)
+  uint32_t table[LED_FADE_MAX_STEPS];
+} led_fade_slice_t;
+
+typedef struct {
+  led_fade_slice_t slices[LED_FADE_MAX_SLICES];
+  led_fade_channel_t channels[LED_FADE_MAX_CHANNELS];
+  uint8_t slice_count, channel_count;
+} led_fade_t;
+
+void led_fade_init(led_fade_t *fade);
+
+// Coloca o pino em modo PWM e reserva o slice; devolve o canal ou -1
+int led_fade_add(led_fade_t *fade, uint gpio);
+
+// Leva o canal ao nível em duration_us pela curva dada, partindo do nível em
+// vigor. Um alvo igual ao atual não reinicia o fade; devolve se houve mudança
+bool led_fade_to(led_fade_t *fade, int channel, uint16_t level, uint32_t duration_us, led_ease_t ease);
+
+// Nível na curva após `step` de `steps` passos
+uint16_t led_fade_ease(uint16_t from, uint16_t to, uint32_t step, uint32_t steps, led_ease_t ease);
+
+// Transporte das tabelas, por plataforma: DMA pelo wrap do PWM no firmware
+// (led_fade_dma.c), um alarme por wrap na simulação (sim/led_fade_sim.c)
+void led_fade_hw_init(uint slice);
+void led_fade_hw_start(uint slice, const uint32_t *table, size_t count);
+// Interrompe a tabela em curso e devolve quantas entradas já estão em vigor na saída
+size_t led_fade_hw_stop(uint slice);
+
+#endif // LED_FADE_H
@@ -0,0 +1,39 @@
+#include "led_fade.h"
+#include "hardware/clocks.h"
+#include "hardware/dma.h"
+#include "hardware/pwm.h"
+
+// Um canal de DMA por slice, pacejado pelo DREQ de wrap do próprio slice: cada
+// wrap copia uma palavra da tabela para o registrador CC, que o PWM só adota
+// no wrap seguinte (duplo buffer do hardware), então não há glitch no meio de
+// um período. Sem IRQ: a CPU não é acordada durante o fade.
+static int dma_channel[NUM_PWM_SLICES];    // canal + 1; 0 = ainda não reservado
+static size_t started[NUM_PWM_SLICES];     // entradas da tabela em curso
+
+void led_fade_hw_init(uint slice) {
+  // Período do PWM = um passo do fade
+  pwm_set_clkdiv(slice, (float)clock_get_hz(clk_sys) / ((LED_FADE_WRAP + 1) * (float)LED_FADE_STEP_HZ));
+  if (!dma_channel[slice])
+    dma_channel[slice] = dma_claim_unused_channel(true) + 1;
+}
+
+void led_fade_hw_start(uint slice, const uint32_t *table, size_t count) {
+  int channel = dma_channel[slice] - 1;
+  dma_channel_config cfg = dma_channel_get_default_config(channel);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_32);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, false);
+  channel_config_set_dreq(&cfg, pwm_get_dreq(slice));
+  started[slice] = count;
+  dma_channel_configure(channel, &cfg, &pwm_hw->slice[slice].cc, table, count, true);
+}
+
+// Devolve as entradas em vigor: a última palavra copiada ainda está no buffer
+// do CC e só vale no próximo wrap, então não conta. O novo fade parte do
+// nível que está na saída, como na simulação
+size_t led_fade_hw_stop(uint slice) {
+  int channel = dma_channel[slice] - 1;
+  dma_channel_abort(channel);
+  size_t copied = started[slice] - dma_channel_hw_addr(channel)->transfer_count;
+  return copied > 0 ? copied - 1 : 0;
+}
@@ -0,0 +1,144 @@
+#include "scheduler.h"
+#include "pico/stdlib.h"
+#include "hardware/sync.h"
+#include <stdio.h>
+#include <string.h>
+
+void sched_init(scheduler_t *s, sched_clock_t now) {
+  memset(s, 0, sizeof(*s));
+  s->now = now;
+}
+
+sched_task_t *sched_add(scheduler_t *s, const char *name, uint32_t period_us, sched_fn_t fn, void *arg) {
+  if (s->count == SCHED_MAX_TASKS || period_us == 0)
+    return NULL;
+  sched_task_t *t = &s->tasks[s->count++];
+  memset(t, 0, sizeof(*t));
+  t->name = name;
+  t->fn = fn;
+  t->arg = arg;
+  t->period_us = period_us;
+  t->cur_period_us = period_us;
+  t->deadline_us = s->now();
+  return t;
+}
+
+void sched_set_droppable(sched_task_t *t, uint32_t max_period_us) {
+  t->max_period_us = max_period_us < t->period_us ? t->period_us : max_period_us;
+}
+
+static void sched_dropped(sched_task_t *t) {
+  t->drops++;
+  t->ok_streak = 0;
+  if (++t->drop_streak >= SCHED_ADAPT_DROPS) {
+    t->drop_streak = 0;
+    t->cur_period_us = t->cur_period_us * 2 > t->max_period_us ? t->max_period_us : t->cur_period_us * 2;
+  }
+}
+
+static void sched_completed(sched_task_t *t) {
+  t->drop_streak = 0;
+  if (++t->ok_streak >= SCHED_ADAPT_RECOVER && t->cur_period_us > t->period_us) {
+    t->ok_streak = 0;
+    t->cur_period_us = t->cur_period_us / 2 < t->period_us ? t->period_us : t->cur_period_us / 2;
+  }
+}
+
+// Primeira tarefa vencida em ordem de prioridade
+static sched_task_t *sched_next_due(scheduler_t *s, uint64_t now) {
+  for (size_t i = 0; i < s->count; ++i)
+    if (s->tasks[i].deadline_us <= now)
+      return &s->tasks[i];
+  return NULL;
+}
+
+// Instante até o qual t pode ocupar a CPU: as tarefas de maior prioridade
+// toleram começar até meio período depois do prazo, o que fica bem abaixo de
+// um prazo perdido (um período inteiro de atraso)
+static uint64_t sched_slack_limit(const scheduler_t *s, const sched_task_t *t) {
+  uint64_t limit = UINT64_MAX;
+  for (const sched_task_t *hp = s->tasks; hp < t; ++hp) {
+    uint64_t latest = hp->deadline_us + hp->cur_period_us / 2;
+    if (latest < limit)
+      limit = latest;
+  }
+  return limit;
+}
+
+uint64_t sched_run(scheduler_t *s) {
+  uint64_t now = s->now();
+  sched_task_t *t;
+
+  while ((t = sched_next_due(s, now)) != NULL) {
+    // Atraso de um período ou mais: os disparos perdidos não são repostos
+    uint64_t late = now - t->deadline_us;
+    if (late >= t->cur_period_us) {
+      uint64_t missed = late / t->cur_period_us;
+      t->misses += missed;
+      t->deadline_us += missed * t->cur_period_us;
+    }
+    t->deadline_us += t->cur_period_us;
+
+    // Tarefa descartável que atrasaria uma de maior prioridade: descarta. A
+    // estimativa de custo decai a cada descarte, para que um pico isolado
+    // (ex.: o primeiro quadro completo) não bloqueie a tarefa para sempre
+    if (t->max_period_us && now + t->cost_us > sched_slack_limit(s, t)) {
+      t->cost_us -= t->cost_us / 4;
+      sched_dropped(t);
+      continue;
+    }
+
+    bool done = t->fn(t->arg);
+    uint64_t end = s->now();
+    t->runs++;
+    t->cost_us = (3 * t->cost_us + (uint32_t)(end - now)) / 4;
+    if (t->max_period_us) {
+      if (done)
+        sched_completed(t);
+      else
+        sched_dropped(t);
+    }
+    now = end;
+  }
+
+  uint64_t next = UINT64_MAX;
+  for (size_t i = 0; i < s->count; ++i)
+    if (s->tasks[i].deadline_us < next)
+      next = s->tasks[i].deadline_us;
+  return next;
+}
+
+// O alarme só existe para tirar o núcleo do __wfi
+static int64_t sched_alarm(alarm_id_t id, void *arg) {
+  (void)id;
+  (void)arg;
+  return 0;
+}
+
+void sched_wait(scheduler_t *s, uint64_t deadline_us) {
+  if (s->now() >= deadline_us)
+    return;
+  add_alarm_at(from_us_since_boot(deadline_us), sched_alarm, NULL, true);
+
+  // Outras IRQs (DMA, GPIO, USB) também acordam o núcleo. Com as interrupções
+  // mascaradas entre o teste e o __wfi, uma IRQ que chegue nesse intervalo
+  // fica pendente e faz o __wfi retornar na hora, sem perder o despertar
+  while (true) {
+    uint32_t irq = save_and_disable_interrupts();
+    bool waiting = s->now() < deadline_us;
+    if (waiting)
+      __wfi();
+    restore_interrupts(irq);
+    if (!waiting)
+      break;
+  }
+}
+
+void sched_report(const scheduler_t *s) {
+  for (size_t i = 0; i < s->count; ++i) {
+    const sched_task_t *t = &s->tasks[i];
+    printf("sched: %-8s periodo %lu us (config %lu), custo %lu us, %lu execucoes, %lu prazos perdidos, %lu descartes\n",
+           t->name, (unsigned long)t->cur_period_us, (unsigned long)t->period_us, (unsigned long)t->cost_us,
+           (unsigned long)t->runs, (unsigned long)t->misses, (unsigned long)t->drops);
+  }
+}
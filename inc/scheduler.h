@@ -0,0 +1,68 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Escalonador cooperativo por prazos. Cada tarefa tem um período e um prazo
+// absoluto; sched_run executa as vencidas em ordem de prioridade (ordem de
+// registro) e devolve o próximo prazo, até o qual sched_wait dorme em __wfi
+// com um alarme de hardware. O relógio é injetado, então a lógica roda igual
+// com time_us_64 na placa ou com o relógio virtual da simulação.
+#define SCHED_MAX_TASKS 8
+
+// Adaptação das tarefas descartáveis: após SCHED_ADAPT_DROPS descartes
+// seguidos o período dobra (até o máximo); após SCHED_ADAPT_RECOVER execuções
+// seguidas sem descarte ele volta pela metade em direção ao configurado
+#define SCHED_ADAPT_DROPS 3
+#define SCHED_ADAPT_RECOVER 50
+
+typedef uint64_t (*sched_clock_t)(void);
+
+// Retorna false quando a tarefa não pôde fazer o trabalho (ex.: barramento
+// ocupado); para tarefas descartáveis isso conta como quadro descartado
+typedef bool (*sched_fn_t)(void *arg);
+
+typedef struct {
+  const char *name;
+  sched_fn_t fn;
+  void *arg;
+  uint32_t period_us;       // período configurado
+  uint32_t cur_period_us;   // período em uso (muda nas tarefas descartáveis)
+  uint32_t max_period_us;   // 0: tarefa fixa; senão, descartável até este período
+  uint64_t deadline_us;     // próximo disparo
+  uint32_t cost_us;         // custo médio recente de uma execução
+  uint32_t runs;
+  uint32_t misses;          // períodos inteiros perdidos por atraso
+  uint32_t drops;           // execuções descartadas (só descartáveis)
+  uint16_t ok_streak;
+  uint16_t drop_streak;
+} sched_task_t;
+
+typedef struct {
+  sched_task_t tasks[SCHED_MAX_TASKS];
+  size_t count;
+  sched_clock_t now;
+} scheduler_t;
+
+void sched_init(scheduler_t *s, sched_clock_t now);
+
+// Registra uma tarefa com o primeiro disparo imediato; NULL se não houver espaço
+sched_task_t *sched_add(scheduler_t *s, const char *name, uint32_t period_us, sched_fn_t fn, void *arg);
+
+// Torna a tarefa descartável: ela só roda se o seu custo médio couber antes
+// que uma tarefa de maior prioridade se atrase meio período, e seu período se
+// adapta aos descartes
+void sched_set_droppable(sched_task_t *t, uint32_t max_period_us);
+
+// Executa as tarefas vencidas e devolve o prazo mais próximo
+uint64_t sched_run(scheduler_t *s);
+
+// Dorme em __wfi até o prazo (um alarme de hardware garante o despertar)
+void sched_wait(scheduler_t *s, uint64_t deadline_us);
+
+// Imprime uma linha por tarefa: execuções, prazos perdidos, descartes
+void sched_report(const scheduler_t *s);
+
+#endif // SCHEDULER_H
@@ -0,0 +1,39 @@
+#include "spsc_queue.h"
+#include <string.h>
+
+void spsc_queue_init(spsc_queue_t *q, void *storage, size_t elem_size, uint32_t capacity) {
+  atomic_init(&q->head, 0);
+  atomic_init(&q->tail, 0);
+  q->mask = capacity - 1;
+  q->elem_size = elem_size;
+  q->storage = storage;
+}
+
+bool spsc_queue_push(spsc_queue_t *q, const void *elem) {
+  uint32_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+  uint32_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+
+  if (head - tail > q->mask)
+    return false;
+
+  memcpy(&q->storage[(head & q->mask) * q->elem_size], elem, q->elem_size);
+  atomic_store_explicit(&q->head, head + 1, memory_order_release);
+  return true;
+}
+
+bool spsc_queue_pop(spsc_queue_t *q, void *elem) {
+  uint32_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+  uint32_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+  if (head == tail)
+    return false;
+
+  memcpy(elem, &q->storage[(tail & q->mask) * q->elem_size], q->elem_size);
+  atomic_store_explicit(&q->tail, tail + 1, memory_order_release);
+  return true;
+}
+
+bool spsc_queue_empty(spsc_queue_t *q) {
+  return atomic_load_explicit(&q->head, memory_order_acquire) ==
+         atomic_load_explicit(&q->tail, memory_order_acquire);
+}
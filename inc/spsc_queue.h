@@ -0,0 +1,26 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Fila sem travas de um produtor e um consumidor para mensagens de tamanho
+// fixo. head só é escrito pelo produtor e tail só pelo consumidor; a ordem
+// acquire/release garante que o conteúdo do elemento fica visível antes do
+// índice. Não depende do SDK, então pode ser exercitada no host com duas threads.
+typedef struct {
+  _Atomic uint32_t head;
+  _Atomic uint32_t tail;
+  uint32_t mask;        // capacidade - 1 (capacidade potência de 2)
+  size_t elem_size;
+  uint8_t *storage;     // capacidade * elem_size bytes
+} spsc_queue_t;
+
+void spsc_queue_init(spsc_queue_t *q, void *storage, size_t elem_size, uint32_t capacity);
+bool spsc_queue_push(spsc_queue_t *q, const void *elem);
+bool spsc_queue_pop(spsc_queue_t *q, void *elem);
+bool spsc_queue_empty(spsc_queue_t *q);
+
+#endif // SPSC_QUEUE_H
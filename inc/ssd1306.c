@@ -1,117 +1,624 @@
 #include "ssd1306.h"
-#include "font.h"
+#include "ssd1306_i2c.h"
+#include "font_ascii.h"
+#include <string.h>
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+static void ssd1306_clear_dirty(ssd1306_t *ssd) {
+  ssd->dirty_x0 = 0xFF;
+  ssd->dirty_x1 = 0;
+  ssd->dirty_p0 = 0xFF;
+  ssd->dirty_p1 = 0;
+}
+
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c,
+                  uint8_t *ram_buffer, uint8_t *scratch_buffer) {
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
   ssd->external_vcc = external_vcc;
-  ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
+  ssd->bufsize = SSD1306_BUFSIZE(width, height);
+  ssd->ram_buffer = ram_buffer;
+  memset(ssd->ram_buffer, 0, ssd->bufsize);
   ssd->ram_buffer[0] = 0x40;
   ssd->port_buffer[0] = 0x80;
-  
-  
+  ssd->scratch_buffer = scratch_buffer;
+  ssd->transport = &ssd1306_i2c_transport;
+  ssd->transport_ctx = ssd1306_i2c_context(i2c);
+  ssd->on_done = NULL;
+  ssd->on_done_arg = NULL;
+  ssd->shadow_buffer = NULL;
+  ssd->shadow_valid = false;
+  ssd->xfer_failed = false;
+  ssd1306_reset_stats(ssd);
+  ssd1306_clear_dirty(ssd);
+
   ssd1306_config(ssd);
 }
 
+// Instância só de desenho (camadas, buffers fora da tela): mesma geometria e
+// primitivas, sem transporte e sem configurar o controlador
+void ssd1306_init_canvas(ssd1306_t *ssd, uint8_t width, uint8_t height, uint8_t *ram_buffer) {
+  memset(ssd, 0, sizeof(*ssd));
+  ssd->width = width;
+  ssd->height = height;
+  ssd->pages = height / 8U;
+  ssd->bufsize = SSD1306_BUFSIZE(width, height);
+  ssd->ram_buffer = ram_buffer;
+  memset(ssd->ram_buffer, 0, ssd->bufsize);
+  ssd->ram_buffer[0] = 0x40;
+  ssd1306_clear_dirty(ssd);
+}
+
 void ssd1306_config(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
-  ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
-  ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
-  ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
-  ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
-  ssd1306_command(ssd, SET_DISP_OFFSET);
-  ssd1306_command(ssd, 0x00);
-  ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
-  ssd1306_command(ssd, SET_DISP_CLK_DIV);
-  ssd1306_command(ssd, 0x80);
-  ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
-  ssd1306_command(ssd, SET_VCOM_DESEL);
-  ssd1306_command(ssd, 0x30);
-  ssd1306_command(ssd, SET_CONTRAST);
-  ssd1306_command(ssd, 0xFF);
-  ssd1306_command(ssd, SET_ENTIRE_ON);
-  ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
-  ssd1306_command(ssd, SET_DISP | 0x01);
+  ssd1306_cmd_stream_t cs;
+  ssd1306_cmd_begin(&cs);
+  ssd1306_cmd_push(&cs, SET_DISP | 0x00);
+  ssd1306_cmd_push(&cs, SET_SCROLL_OFF);  // o painel mantém a rolagem após um reset só do RP2040
+  ssd1306_cmd_push(&cs, SET_MEM_ADDR);
+  ssd1306_cmd_push(&cs, 0x01);
+  ssd1306_cmd_push(&cs, SET_DISP_START_LINE | 0x00);
+  ssd1306_cmd_push(&cs, SET_SEG_REMAP | 0x01);
+  ssd1306_cmd_push(&cs, SET_MUX_RATIO);
+  ssd1306_cmd_push(&cs, ssd->height - 1);
+  ssd1306_cmd_push(&cs, SET_COM_OUT_DIR | 0x08);
+  ssd1306_cmd_push(&cs, SET_DISP_OFFSET);
+  ssd1306_cmd_push(&cs, 0x00);
+  ssd1306_cmd_push(&cs, SET_COM_PIN_CFG);
+  ssd1306_cmd_push(&cs, ssd->height == 64 ? 0x12 : 0x02);  // COM alternado só nos painéis de 64 linhas
+  ssd1306_cmd_push(&cs, SET_DISP_CLK_DIV);
+  ssd1306_cmd_push(&cs, 0x80);
+  ssd1306_cmd_push(&cs, SET_PRECHARGE);
+  ssd1306_cmd_push(&cs, 0xF1);
+  ssd1306_cmd_push(&cs, SET_VCOM_DESEL);
+  ssd1306_cmd_push(&cs, 0x30);
+  ssd1306_cmd_push(&cs, SET_CONTRAST);
+  ssd1306_cmd_push(&cs, 0xFF);
+  ssd1306_cmd_push(&cs, SET_ENTIRE_ON);
+  ssd1306_cmd_push(&cs, SET_NORM_INV);
+  ssd1306_cmd_push(&cs, SET_CHARGE_PUMP);
+  ssd1306_cmd_push(&cs, 0x14);
+  ssd1306_cmd_push(&cs, SET_DISP | 0x01);
+  ssd1306_cmd_send(ssd, &cs);
+}
+
+// Toda escrita bloqueante passa por aqui para contabilizar o tráfego: cada
+// transação custa, além do conteúdo, o byte de endereço
+static void ssd1306_write(ssd1306_t *ssd, const uint8_t *src, size_t len) {
+  ssd1306_wait(ssd);
+  ssd->transport->write(ssd->transport_ctx, ssd->address, src, len);
+  ssd->stats.transactions++;
+  ssd->stats.bus_bytes += len + 1;
 }
 
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   ssd->port_buffer[1] = command;
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->port_buffer,
-    2,
-    false
-  );
+  ssd1306_write(ssd, ssd->port_buffer, 2);
+}
+
+void ssd1306_cmd_begin(ssd1306_cmd_stream_t *cs) {
+  cs->buf[0] = 0x00; // Co = 0, D/C# = 0: todos os bytes seguintes são comandos
+  cs->len = 1;
+}
+
+void ssd1306_cmd_push(ssd1306_cmd_stream_t *cs, uint8_t command) {
+  if (cs->len < sizeof(cs->buf))
+    cs->buf[cs->len++] = command;
+}
+
+void ssd1306_cmd_send(ssd1306_t *ssd, ssd1306_cmd_stream_t *cs) {
+  if (cs->len > 1)
+    ssd1306_write(ssd, cs->buf, cs->len);
+  ssd1306_cmd_begin(cs);
+}
+
+static void ssd1306_cmd_window(ssd1306_cmd_stream_t *cs, uint8_t c0, uint8_t c1, uint8_t p0, uint8_t p1) {
+  ssd1306_cmd_push(cs, SET_COL_ADDR);
+  ssd1306_cmd_push(cs, c0);
+  ssd1306_cmd_push(cs, c1);
+  ssd1306_cmd_push(cs, SET_PAGE_ADDR);
+  ssd1306_cmd_push(cs, p0);
+  ssd1306_cmd_push(cs, p1);
 }
 
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  ssd1306_cmd_stream_t cs;
+  ssd1306_cmd_begin(&cs);
+  ssd1306_cmd_window(&cs, 0, ssd->width - 1, 0, ssd->pages - 1);
+  ssd1306_cmd_send(ssd, &cs);
+  ssd1306_write(ssd, ssd->ram_buffer, ssd->bufsize);
+  ssd1306_clear_dirty(ssd);
+
+  if (ssd->shadow_buffer) {
+    memcpy(ssd->shadow_buffer, ssd->ram_buffer, ssd->bufsize);
+    ssd->shadow_valid = true;
+  }
+  ssd->stats.frames_sent++;
+  ssd->stats.bytes_sent += ssd->bufsize;
 }
 
-void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
-  uint8_t pixel = (y & 0b111);
-  if (value)
-      ssd->ram_buffer[index] |= (1 << pixel);
-  else
-      ssd->ram_buffer[index] &= ~(1 << pixel);
+typedef struct {
+  uint8_t c0, c1, p0, p1;
+} ssd1306_window_t;
+
+// Copia os bytes da janela para dst. Com endereçamento vertical o controlador
+// percorre as páginas de cada coluna, então a cópia é feita coluna a coluna.
+static size_t ssd1306_gather(ssd1306_t *ssd, const ssd1306_window_t *w, uint8_t *dst) {
+  uint8_t npages = w->p1 - w->p0 + 1;
+  size_t len = 0;
+
+  for (uint8_t x = w->c0; x <= w->c1; ++x) {
+    memcpy(&dst[len], &ssd->ram_buffer[x * ssd->pages + w->p0 + 1], npages);
+    len += npages;
+  }
+  return len;
 }
 
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+// A cópia sombra acompanha o que foi enviado: só é atualizada depois que o
+// transporte aceitou as janelas
+static void ssd1306_update_shadow(ssd1306_t *ssd, const ssd1306_window_t *windows, size_t count) {
+  if (!ssd->shadow_buffer)
+    return;
+  for (size_t i = 0; i < count; ++i) {
+    const ssd1306_window_t *w = &windows[i];
+    uint8_t npages = w->p1 - w->p0 + 1;
+    for (uint8_t x = w->c0; x <= w->c1; ++x) {
+      size_t offset = x * ssd->pages + w->p0 + 1;
+      memcpy(&ssd->shadow_buffer[offset], &ssd->ram_buffer[offset], npages);
     }
+  }
 }
 
+// Envia apenas a janela [c0..c1] x [p0..p1], bloqueando até o fim.
+static size_t ssd1306_send_window(ssd1306_t *ssd, const ssd1306_window_t *w) {
+  size_t len = 1 + ssd1306_gather(ssd, w, &ssd->scratch_buffer[1]);
 
+  ssd1306_cmd_stream_t cs;
 
-void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
-  for (uint8_t x = left; x < left + width; ++x) {
-    ssd1306_pixel(ssd, x, top, value);
-    ssd1306_pixel(ssd, x, top + height - 1, value);
+  ssd->scratch_buffer[0] = 0x40;
+  ssd1306_cmd_begin(&cs);
+  ssd1306_cmd_window(&cs, w->c0, w->c1, w->p0, w->p1);
+  ssd1306_cmd_send(ssd, &cs);
+  ssd1306_write(ssd, ssd->scratch_buffer, len);
+  ssd1306_update_shadow(ssd, w, 1);
+  return len;
+}
+
+// Chamado pelo transporte, possivelmente em interrupção: só registra a falha,
+// tratada no envio seguinte (ssd1306_recover)
+static void ssd1306_transfer_done(void *arg, bool ok) {
+  ssd1306_t *ssd = arg;
+  if (!ok)
+    ssd->xfer_failed = true;
+  if (ssd->on_done)
+    ssd->on_done(ssd->on_done_arg);
+}
+
+// Monta todas as janelas no buffer auxiliar (comandos + dados) e entrega a
+// sequência ao transporte de uma só vez. O transporte copia os segmentos antes
+// de retornar, então ram_buffer fica livre para o próximo quadro. Se ele
+// recusar a sequência, retorna false sem alterar a cópia sombra nem o tráfego.
+static bool ssd1306_queue_windows(ssd1306_t *ssd, const ssd1306_window_t *windows, size_t count, size_t *sent) {
+  ssd1306_segment_t segs[2 * SSD1306_MAX_WINDOWS];
+  uint8_t *dst = ssd->scratch_buffer;
+
+  *sent = 0;
+  for (size_t i = 0; i < count; ++i) {
+    const ssd1306_window_t *w = &windows[i];
+    ssd1306_cmd_stream_t cs;
+    ssd1306_cmd_begin(&cs);
+    ssd1306_cmd_window(&cs, w->c0, w->c1, w->p0, w->p1);
+    memcpy(dst, cs.buf, cs.len);
+    segs[2 * i].data = dst;
+    segs[2 * i].len = cs.len;
+    dst += cs.len;
+
+    uint8_t *data = dst;
+    data[0] = 0x40;
+    size_t len = 1 + ssd1306_gather(ssd, w, &data[1]);
+    segs[2 * i + 1].data = data;
+    segs[2 * i + 1].len = len;
+    dst += len;
+    *sent += len;
+
+    if (i == 0 || w->c0 < ssd->xfer_x0) ssd->xfer_x0 = w->c0;
+    if (i == 0 || w->c1 > ssd->xfer_x1) ssd->xfer_x1 = w->c1;
+    if (i == 0 || w->p0 < ssd->xfer_p0) ssd->xfer_p0 = w->p0;
+    if (i == 0 || w->p1 > ssd->xfer_p1) ssd->xfer_p1 = w->p1;
+  }
+
+  if (ssd->transport->write_async) {
+    if (!ssd->transport->write_async(ssd->transport_ctx, ssd->address, segs, 2 * count,
+                                     ssd1306_transfer_done, ssd))
+      return false;
+  } else {
+    // Transporte sem suporte assíncrono: envia os segmentos em sequência
+    for (size_t i = 0; i < 2 * count; ++i)
+      ssd->transport->write(ssd->transport_ctx, ssd->address, segs[i].data, segs[i].len);
+    ssd1306_transfer_done(ssd, true);
   }
-  for (uint8_t y = top; y < top + height; ++y) {
-    ssd1306_pixel(ssd, left, y, value);
-    ssd1306_pixel(ssd, left + width - 1, y, value);
+
+  for (size_t i = 0; i < 2 * count; ++i) {
+    ssd->stats.transactions++;
+    ssd->stats.bus_bytes += segs[i].len + 1;
   }
+  ssd1306_update_shadow(ssd, windows, count);
+  return true;
+}
 
-  if (fill) {
-    for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-      for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-        ssd1306_pixel(ssd, x, y, value);
+// Compara a região suja com a cópia do último quadro enviado e gera as faixas
+// de colunas que mudaram. Faixas separadas por poucas colunas iguais são unidas
+// quando reenviar o intervalo custa menos que uma nova janela; se o limite de
+// janelas for atingido, a última absorve o restante.
+static size_t ssd1306_diff_windows(ssd1306_t *ssd, ssd1306_window_t *windows) {
+  size_t count = 0;
+  ssd1306_window_t *cur_w = NULL;
+
+  for (uint8_t x = ssd->dirty_x0; x <= ssd->dirty_x1; ++x) {
+    const uint8_t *cur = &ssd->ram_buffer[x * ssd->pages + 1];
+    const uint8_t *old = &ssd->shadow_buffer[x * ssd->pages + 1];
+    uint8_t lo = 0xFF, hi = 0;
+
+    for (uint8_t p = ssd->dirty_p0; p <= ssd->dirty_p1; ++p) {
+      if (cur[p] != old[p]) {
+        if (lo == 0xFF) lo = p;
+        hi = p;
+      }
+    }
+    if (lo == 0xFF)
+      continue;
+
+    if (cur_w) {
+      uint8_t u0 = lo < cur_w->p0 ? lo : cur_w->p0;
+      uint8_t u1 = hi > cur_w->p1 ? hi : cur_w->p1;
+      if (count == SSD1306_MAX_WINDOWS ||
+          (size_t)(x - cur_w->c1 - 1) * (u1 - u0 + 1) <= SSD1306_SPAN_OVERHEAD) {
+        cur_w->c1 = x;
+        cur_w->p0 = u0;
+        cur_w->p1 = u1;
+        continue;
       }
     }
+    cur_w = &windows[count++];
+    cur_w->c0 = cur_w->c1 = x;
+    cur_w->p0 = lo;
+    cur_w->p1 = hi;
   }
+  return count;
 }
 
-void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+// A última transferência assíncrona abortou: o painel não mostra as janelas
+// dela, mas a cópia sombra foi atualizada ao enfileirá-las. A cópia deixa de
+// valer e a região volta a ficar suja; true se havia falha a tratar
+static bool ssd1306_recover(ssd1306_t *ssd) {
+  if (!ssd->xfer_failed)
+    return false;
+  ssd->xfer_failed = false;
+  ssd->shadow_valid = false;
+  ssd->stats.transfer_errors++;
+  ssd1306_mark_dirty(ssd, ssd->xfer_x0, ssd->xfer_p0 * 8, ssd->xfer_x1, ssd->xfer_p1 * 8);
+  return true;
+}
+
+static void ssd1306_account(ssd1306_t *ssd, size_t sent) {
+  if (sent == 0) {
+    ssd->stats.frames_skipped++;
+  } else {
+    ssd->stats.frames_sent++;
+    ssd->stats.bytes_sent += sent;
+  }
+  // Cada janela conta o próprio byte de controle, então várias janelas (ou
+  // áreas sobrepostas) podem passar do tamanho do quadro: nada foi economizado
+  if (sent < ssd->bufsize)
+    ssd->stats.bytes_saved += ssd->bufsize - sent;
+}
+
+// false só no modo assíncrono, se o transporte recusar a transferência
+static bool ssd1306_transmit(ssd1306_t *ssd, const ssd1306_window_t *windows, size_t count, bool async,
+                             size_t *sent) {
+  if (count && async)
+    return ssd1306_queue_windows(ssd, windows, count, sent);
+
+  *sent = 0;
+  for (size_t i = 0; i < count; ++i)
+    *sent += ssd1306_send_window(ssd, &windows[i]);
+  return true;
+}
+
+// Caminho comum de envio: define as janelas (tela inteira, região suja ou
+// diferenças em relação à cópia sombra) e as transmite de forma bloqueante ou
+// assíncrona. No modo assíncrono retorna false, sem descartar a região suja,
+// se a transferência anterior ainda estiver em andamento ou se o transporte
+// recusar a nova.
+static bool ssd1306_flush(ssd1306_t *ssd, bool full, bool diff, bool async) {
+  if (async) {
+    if (ssd1306_is_busy(ssd))
+      return false;
+  } else {
+    ssd1306_wait(ssd);
+  }
+  ssd1306_recover(ssd);
+
+  ssd1306_window_t windows[SSD1306_MAX_WINDOWS];
+  size_t count = 0;
+
+  if (diff && (!ssd->shadow_buffer || !ssd->shadow_valid))
+    full = true;
+
+  if (full) {
+    windows[0] = (ssd1306_window_t){0, ssd->width - 1, 0, ssd->pages - 1};
+    count = 1;
+  } else if (ssd->dirty_x0 <= ssd->dirty_x1) {
+    if (diff) {
+      count = ssd1306_diff_windows(ssd, windows);
+    } else {
+      windows[0] = (ssd1306_window_t){ssd->dirty_x0, ssd->dirty_x1, ssd->dirty_p0, ssd->dirty_p1};
+      count = 1;
+    }
+  }
+
+  size_t sent;
+  if (!ssd1306_transmit(ssd, windows, count, async, &sent))
+    return false;
+
+  if (full && ssd->shadow_buffer)
+    ssd->shadow_valid = true;
+  ssd1306_clear_dirty(ssd);
+  ssd1306_account(ssd, sent);
+  return true;
+}
+
+// Envio de uma lista de áreas calculada fora do driver (ex.: danos de uma
+// cena). A região suja é descartada: quem fornece as áreas responde por elas
+static bool ssd1306_flush_areas(ssd1306_t *ssd, const ssd1306_area_t *areas, size_t count, bool async) {
+  if (async) {
+    if (ssd1306_is_busy(ssd))
+      return false;
+  } else {
+    ssd1306_wait(ssd);
+  }
+  // As áreas não cobrem o que uma transferência abortada deixou de mostrar
+  bool retry = ssd1306_recover(ssd);
+
+  ssd1306_window_t windows[SSD1306_MAX_WINDOWS];
+  size_t n = 0;
+
+  for (size_t i = 0; i <= count; ++i) {
+    ssd1306_window_t w;
+    if (i == count) {
+      if (!retry)
+        break;
+      w = (ssd1306_window_t){ ssd->xfer_x0, ssd->xfer_x1, ssd->xfer_p0, ssd->xfer_p1 };
+    } else {
+      int x0 = areas[i].x0 > 0 ? areas[i].x0 : 0;
+      int y0 = areas[i].y0 > 0 ? areas[i].y0 : 0;
+      int x1 = areas[i].x1 < ssd->width - 1 ? areas[i].x1 : ssd->width - 1;
+      int y1 = areas[i].y1 < ssd->height - 1 ? areas[i].y1 : ssd->height - 1;
+      if (x0 > x1 || y0 > y1)
+        continue;
+      w = (ssd1306_window_t){ x0, x1, y0 >> 3, y1 >> 3 };
+    }
+
+    if (n == SSD1306_MAX_WINDOWS) {
+      // Sem janelas livres: a última passa a envolver as restantes
+      ssd1306_window_t *last = &windows[n - 1];
+      if (w.c0 < last->c0) last->c0 = w.c0;
+      if (w.c1 > last->c1) last->c1 = w.c1;
+      if (w.p0 < last->p0) last->p0 = w.p0;
+      if (w.p1 > last->p1) last->p1 = w.p1;
+    } else {
+      windows[n++] = w;
+    }
+  }
+
+  size_t sent;
+  if (!ssd1306_transmit(ssd, windows, n, async, &sent))
+    return false;
+
+  ssd1306_clear_dirty(ssd);
+  ssd1306_account(ssd, sent);
+  return true;
+}
+
+void ssd1306_send_dirty(ssd1306_t *ssd) {
+  ssd1306_flush(ssd, false, false, false);
+}
+
+// shadow_buffer: SSD1306_BUFSIZE(width, height) bytes do chamador
+void ssd1306_enable_shadow(ssd1306_t *ssd, uint8_t *shadow_buffer) {
+  ssd->shadow_buffer = shadow_buffer;
+  ssd->shadow_valid = false;
+}
+
+void ssd1306_send_diff(ssd1306_t *ssd) {
+  ssd1306_flush(ssd, false, true, false);
+}
+
+bool ssd1306_send_data_async(ssd1306_t *ssd) {
+  return ssd1306_flush(ssd, true, false, true);
+}
+
+bool ssd1306_send_dirty_async(ssd1306_t *ssd) {
+  return ssd1306_flush(ssd, false, false, true);
+}
+
+bool ssd1306_send_diff_async(ssd1306_t *ssd) {
+  return ssd1306_flush(ssd, false, true, true);
+}
+
+// As áreas são arredondadas para páginas inteiras e não devem se sobrepor;
+// além de SSD1306_MAX_WINDOWS, as excedentes são unidas à última janela
+void ssd1306_send_areas(ssd1306_t *ssd, const ssd1306_area_t *areas, size_t count) {
+  ssd1306_flush_areas(ssd, areas, count, false);
+}
+
+bool ssd1306_send_areas_async(ssd1306_t *ssd, const ssd1306_area_t *areas, size_t count) {
+  return ssd1306_flush_areas(ssd, areas, count, true);
+}
+
+bool ssd1306_is_busy(ssd1306_t *ssd) {
+  return ssd->transport->busy && ssd->transport->busy(ssd->transport_ctx);
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+  while (ssd1306_is_busy(ssd))
+    tight_loop_contents();
+}
+
+void ssd1306_set_callback(ssd1306_t *ssd, ssd1306_done_cb_t callback, void *arg) {
+  ssd->on_done = callback;
+  ssd->on_done_arg = arg;
+}
+
+void ssd1306_set_transport(ssd1306_t *ssd, const ssd1306_transport_t *transport, void *ctx) {
+  ssd1306_wait(ssd);
+  ssd->transport = transport;
+  ssd->transport_ctx = ctx;
+}
+
+void ssd1306_group_init(ssd1306_group_t *group) {
+  group->count = 0;
+  group->next = 0;
+}
+
+bool ssd1306_group_add(ssd1306_group_t *group, ssd1306_t *ssd) {
+  if (group->count == SSD1306_MAX_DISPLAYS)
+    return false;
+  group->displays[group->count++] = ssd;
+  return true;
+}
+
+// Inicia o envio diferencial assíncrono de cada display cujo barramento está
+// livre. Displays que compartilham a porta esperam a vez: a próxima rodada
+// começa pelo primeiro que ficou de fora, para que nenhum seja sempre
+// preterido. Retorna quantos displays foram atendidos.
+size_t ssd1306_group_flush(ssd1306_group_t *group) {
+  size_t flushed = 0;
+  size_t skipped = SIZE_MAX;
+
+  for (size_t i = 0; i < group->count; ++i) {
+    size_t index = (group->next + i) % group->count;
+    if (ssd1306_send_diff_async(group->displays[index]))
+      flushed++;
+    else if (skipped == SIZE_MAX)
+      skipped = index;
+  }
+  if (skipped != SIZE_MAX)
+    group->next = skipped;
+  return flushed;
+}
+
+bool ssd1306_group_busy(ssd1306_group_t *group) {
+  for (size_t i = 0; i < group->count; ++i)
+    if (ssd1306_is_busy(group->displays[i]))
+      return true;
+  return false;
+}
+
+void ssd1306_group_wait(ssd1306_group_t *group) {
+  while (ssd1306_group_busy(group))
+    tight_loop_contents();
+}
+
+const ssd1306_stats_t *ssd1306_get_stats(const ssd1306_t *ssd) {
+  return &ssd->stats;
+}
+
+void ssd1306_reset_stats(ssd1306_t *ssd) {
+  memset(&ssd->stats, 0, sizeof(ssd->stats));
+}
+
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1) {
+  uint8_t p0 = y0 >> 3;
+  uint8_t p1 = y1 >> 3;
+  if (x0 < ssd->dirty_x0) ssd->dirty_x0 = x0;
+  if (x1 > ssd->dirty_x1) ssd->dirty_x1 = x1;
+  if (p0 < ssd->dirty_p0) ssd->dirty_p0 = p0;
+  if (p1 > ssd->dirty_p1) ssd->dirty_p1 = p1;
+}
+
+// Recorte de toda a tela, usado pelas funções sem janela
+static ssd1306_area_t ssd1306_screen(const ssd1306_t *ssd) {
+  return (ssd1306_area_t){ 0, 0, ssd->width - 1, ssd->height - 1 };
+}
+
+// Escreve um pixel já validado, sem marcar a região suja
+static inline void ssd1306_put(ssd1306_t *ssd, int x, int y, bool value) {
+  uint8_t *b = &ssd->ram_buffer[x * ssd->pages + (y >> 3) + 1];
+  uint8_t bit = 1u << (y & 7);
+  *b = value ? (*b | bit) : (*b & ~bit);
+}
+
+void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  ssd1306_put(ssd, x, y, value);
+  ssd1306_mark_dirty(ssd, x, y, x, y);
+}
+
+// Preenche o retângulo [x0..x1] x [y0..y1] trabalhando por página: em cada
+// coluna há no máximo uma escrita mascarada na página superior, escritas
+// diretas nas páginas intermediárias e uma escrita mascarada na inferior.
+// O retângulo é recortado uma única vez pela área clip (contida na tela).
+static void ssd1306_fill_area(ssd1306_t *ssd, int x0, int y0, int x1, int y1, const ssd1306_area_t *clip, bool value) {
+  if (x0 < clip->x0) x0 = clip->x0;
+  if (y0 < clip->y0) y0 = clip->y0;
+  if (x1 > clip->x1) x1 = clip->x1;
+  if (y1 > clip->y1) y1 = clip->y1;
+  if (x0 > x1 || y0 > y1)
+    return;
+
+  uint8_t p0 = y0 >> 3;
+  uint8_t p1 = y1 >> 3;
+  uint8_t top = 0xFF << (y0 & 7);
+  uint8_t bottom = 0xFF >> (7 - (y1 & 7));
+  uint8_t solid = value ? 0xFF : 0x00;
+
+  if (p0 == p1) {
+    top &= bottom;
+  }
+  ssd1306_mark_dirty(ssd, x0, y0, x1, y1);
+
+  for (int x = x0; x <= x1; ++x) {
+    uint8_t *col = &ssd->ram_buffer[x * ssd->pages + 1];
+
+    col[p0] = value ? (col[p0] | top) : (col[p0] & ~top);
+    if (p0 == p1)
+      continue;
+    for (uint8_t p = p0 + 1; p < p1; ++p)
+      col[p] = solid;
+    col[p1] = value ? (col[p1] | bottom) : (col[p1] & ~bottom);
+  }
+}
+
+static void ssd1306_rect_area(ssd1306_t *ssd, int x, int y, int w, int h, const ssd1306_area_t *clip, bool value, bool fill) {
+  if (w <= 0 || h <= 0)
+    return;
+
+  int right = x + w - 1;
+  int bottom = y + h - 1;
+
+  if (fill) {
+    ssd1306_fill_area(ssd, x, y, right, bottom, clip, value);
+    return;
+  }
+  ssd1306_fill_area(ssd, x, y, right, y, clip, value);
+  ssd1306_fill_area(ssd, x, bottom, right, bottom, clip, value);
+  ssd1306_fill_area(ssd, x, y, x, bottom, clip, value);
+  ssd1306_fill_area(ssd, right, y, right, bottom, clip, value);
+}
+
+// Bresenham. O recorte é decidido uma vez pelo retângulo envolvente: linha
+// inteira dentro da área dispensa testes por pixel; só a linha que cruza a
+// borda da área testa cada ponto.
+static void ssd1306_line_area(ssd1306_t *ssd, int x0, int y0, int x1, int y1, const ssd1306_area_t *clip, bool value) {
+    int bx0 = x0 < x1 ? x0 : x1, bx1 = x0 < x1 ? x1 : x0;
+    int by0 = y0 < y1 ? y0 : y1, by1 = y0 < y1 ? y1 : y0;
+    if (bx1 < clip->x0 || bx0 > clip->x1 || by1 < clip->y0 || by0 > clip->y1)
+        return;
+    bool inside = bx0 >= clip->x0 && bx1 <= clip->x1 && by0 >= clip->y0 && by1 <= clip->y1;
+
     int dx = abs(x1 - x0);
     int dy = abs(y1 - y0);
 
@@ -121,7 +628,8 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
     int err = dx - dy;
 
     while (true) {
-        ssd1306_pixel(ssd, x0, y0, value); // Desenha o pixel atual
+        if (inside || (x0 >= clip->x0 && x0 <= clip->x1 && y0 >= clip->y0 && y0 <= clip->y1))
+            ssd1306_put(ssd, x0, y0, value); // Desenha o pixel atual
 
         if (x0 == x1 && y0 == y1) break; // Termina quando alcança o ponto final
 
@@ -137,54 +645,178 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
             y0 += sy;
         }
     }
+
+    // A região suja é o retângulo envolvente recortado
+    ssd1306_mark_dirty(ssd, bx0 > clip->x0 ? bx0 : clip->x0, by0 > clip->y0 ? by0 : clip->y0,
+                       bx1 < clip->x1 ? bx1 : clip->x1, by1 < clip->y1 ? by1 : clip->y1);
+}
+
+// Cada byte do glifo é uma coluna de 8 pixels, no mesmo formato das páginas do
+// display: com y múltiplo de 8 e o glifo inteiro visível a coluna é copiada
+// direto para ram_buffer; caso contrário é deslocada, mascarada pelas linhas
+// visíveis e combinada com as duas páginas que ela atravessa.
+static void ssd1306_char_area(ssd1306_t *ssd, char c, int x, int y, const ssd1306_area_t *clip) {
+  if (c < FONT_ASCII_FIRST || c > FONT_ASCII_LAST)
+    return;
+
+  int cx0 = x > clip->x0 ? x : clip->x0;
+  int cx1 = x + 7 < clip->x1 ? x + 7 : clip->x1;
+  int cy0 = y > clip->y0 ? y : clip->y0;
+  int cy1 = y + 7 < clip->y1 ? y + 7 : clip->y1;
+  if (cx0 > cx1 || cy0 > cy1)
+    return;
+
+  const uint8_t *glyph = &font_ascii[c - FONT_ASCII_FIRST][cx0 - x];
+  int page = (y - (y & 7)) / 8;  // arredonda para baixo também com y negativo
+  uint8_t shift = y & 7;
+  uint8_t *col = &ssd->ram_buffer[cx0 * ssd->pages + page + 1];
+
+  ssd1306_mark_dirty(ssd, cx0, cy0, cx1, cy1);
+
+  if (shift == 0 && cy0 == y && cy1 == y + 7) {
+    for (int i = cx0; i <= cx1; ++i, col += ssd->pages)
+      *col = *glyph++;
+    return;
+  }
+
+  // Linhas visíveis do glifo, já na posição das duas páginas
+  uint8_t rows = (0xFF << (cy0 - y)) & (0xFF >> (y + 7 - cy1));
+  uint16_t mask = (uint16_t)rows << shift;
+  uint8_t mask_lo = mask & 0xFF;
+  uint8_t mask_hi = mask >> 8;
+  for (int i = cx0; i <= cx1; ++i, col += ssd->pages) {
+    uint16_t bits = (uint16_t)(*glyph++ & rows) << shift;
+    if (mask_lo)
+      col[0] = (col[0] & ~mask_lo) | (bits & 0xFF);
+    if (mask_hi)
+      col[1] = (col[1] & ~mask_hi) | (bits >> 8);
+  }
 }
 
+void ssd1306_fill(ssd1306_t *ssd, bool value) {
+  // O buffer é contínuo na memória: basta preencher todos os bytes de uma vez
+  memset(&ssd->ram_buffer[1], value ? 0xFF : 0x00, ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+}
+
+void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+  ssd1306_area_t screen = ssd1306_screen(ssd);
+  ssd1306_rect_area(ssd, left, top, width, height, &screen, value, fill);
+}
+
+void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value) {
+  ssd1306_area_t screen = ssd1306_screen(ssd);
+  ssd1306_line_area(ssd, x0, y0, x1, y1, &screen, value);
+}
 
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value) {
-  for (uint8_t x = x0; x <= x1; ++x)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_area_t screen = ssd1306_screen(ssd);
+  ssd1306_fill_area(ssd, x0, y, x1, y, &screen, value);
 }
 
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value) {
-  for (uint8_t y = y0; y <= y1; ++y)
-    ssd1306_pixel(ssd, x, y, value);
+  ssd1306_area_t screen = ssd1306_screen(ssd);
+  ssd1306_fill_area(ssd, x, y0, x, y1, &screen, value);
 }
 
 // Função para desenhar um caractere
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y) {
-  uint16_t index = 0;
-
-  if (c >= 'A' && c <= 'Z') {
-      index = (c - 'A' + 11) * 8; // Para letras maiúsculas
-  } else if (c >= 'a' && c <= 'z') {
-      index = (c - 'a' + 37) * 8; // Para minúsculas
-  } else if (c >= '0' && c <= '9') {
-      index = (c - '0' + 1) * 8; // Para números
-  } else {
-      // Caracteres não suportados
-      return;
-  }
-
-  for (uint8_t i = 0; i < 8; ++i) {
-      uint8_t line = font[index + i];
-      for (uint8_t j = 0; j < 8; ++j) {
-          ssd1306_pixel(ssd, x + i, y + j, line & (1 << j));
-      }
-  }
+  ssd1306_area_t screen = ssd1306_screen(ssd);
+  ssd1306_char_area(ssd, c, x, y, &screen);
 }
 
-
 // Função para desenhar uma string
+// Quebra a linha ao alcançar a borda direita e para na última linha inteira
 void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) {
+  ssd1306_area_t screen = ssd1306_screen(ssd);
+  int cx = x, cy = y;
+
   while (*str) {
-      ssd1306_draw_char(ssd, *str++, x, y);
-      x += 8;
-      if (x + 8 >= ssd->width) {
-          x = 0;
-          y += 8;
+      ssd1306_char_area(ssd, *str++, cx, cy, &screen);
+      cx += 8;
+      if (cx + 8 >= ssd->width) {
+          cx = 0;
+          cy += 8;
       }
-      if (y + 8 >= ssd->height) {
+      if (cy + 8 >= ssd->height) {
           break;
       }
   }
-}
\ No newline at end of file
+}
+
+// Janelas: as coordenadas são relativas à origem da janela e todo desenho é
+// recortado pelo seu retângulo visível, que por sua vez está contido na tela.
+// Como a região suja é marcada já recortada, o envio parcial cobre apenas a
+// parte da janela que mudou.
+static void ssd1306_view_set(ssd1306_view_t *view, ssd1306_t *ssd, int x, int y, int w, int h,
+                             const ssd1306_area_t *bounds) {
+  view->ssd = ssd;
+  view->ox = x;
+  view->oy = y;
+  view->clip.x0 = x > bounds->x0 ? x : bounds->x0;
+  view->clip.y0 = y > bounds->y0 ? y : bounds->y0;
+  view->clip.x1 = x + w - 1 < bounds->x1 ? x + w - 1 : bounds->x1;
+  view->clip.y1 = y + h - 1 < bounds->y1 ? y + h - 1 : bounds->y1;
+}
+
+void ssd1306_view_init(ssd1306_view_t *view, ssd1306_t *ssd, int x, int y, int w, int h) {
+  ssd1306_area_t screen = ssd1306_screen(ssd);
+  ssd1306_view_set(view, ssd, x, y, w, h, &screen);
+}
+
+void ssd1306_view_sub(ssd1306_view_t *view, const ssd1306_view_t *parent, int x, int y, int w, int h) {
+  ssd1306_view_set(view, parent->ssd, parent->ox + x, parent->oy + y, w, h, &parent->clip);
+}
+
+bool ssd1306_view_empty(const ssd1306_view_t *view) {
+  return view->clip.x0 > view->clip.x1 || view->clip.y0 > view->clip.y1;
+}
+
+void ssd1306_view_invalidate(ssd1306_view_t *view) {
+  if (!ssd1306_view_empty(view))
+    ssd1306_mark_dirty(view->ssd, view->clip.x0, view->clip.y0, view->clip.x1, view->clip.y1);
+}
+
+void ssd1306_view_pixel(ssd1306_view_t *view, int x, int y, bool value) {
+  x += view->ox;
+  y += view->oy;
+  if (x < view->clip.x0 || x > view->clip.x1 || y < view->clip.y0 || y > view->clip.y1)
+    return;
+  ssd1306_put(view->ssd, x, y, value);
+  ssd1306_mark_dirty(view->ssd, x, y, x, y);
+}
+
+void ssd1306_view_fill(ssd1306_view_t *view, bool value) {
+  const ssd1306_area_t *c = &view->clip;
+  ssd1306_fill_area(view->ssd, c->x0, c->y0, c->x1, c->y1, c, value);
+}
+
+void ssd1306_view_rect(ssd1306_view_t *view, int x, int y, int w, int h, bool value, bool fill) {
+  ssd1306_rect_area(view->ssd, view->ox + x, view->oy + y, w, h, &view->clip, value, fill);
+}
+
+void ssd1306_view_hline(ssd1306_view_t *view, int x0, int x1, int y, bool value) {
+  y += view->oy;
+  ssd1306_fill_area(view->ssd, view->ox + x0, y, view->ox + x1, y, &view->clip, value);
+}
+
+void ssd1306_view_vline(ssd1306_view_t *view, int x, int y0, int y1, bool value) {
+  x += view->ox;
+  ssd1306_fill_area(view->ssd, x, view->oy + y0, x, view->oy + y1, &view->clip, value);
+}
+
+void ssd1306_view_line(ssd1306_view_t *view, int x0, int y0, int x1, int y1, bool value) {
+  ssd1306_line_area(view->ssd, view->ox + x0, view->oy + y0, view->ox + x1, view->oy + y1, &view->clip, value);
+}
+
+void ssd1306_view_draw_char(ssd1306_view_t *view, char c, int x, int y) {
+  ssd1306_char_area(view->ssd, c, view->ox + x, view->oy + y, &view->clip);
+}
+
+// Sem quebra de linha: o que passa da janela é recortado
+void ssd1306_view_draw_string(ssd1306_view_t *view, const char *str, int x, int y) {
+  x += view->ox;
+  y += view->oy;
+  for (; *str && x <= view->clip.x1; x += 8)
+    ssd1306_char_area(view->ssd, *str++, x, y, &view->clip);
+}
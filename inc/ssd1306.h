@@ -1,9 +1,28 @@
+#ifndef SSD1306_H
+#define SSD1306_H
+
 #include <stdlib.h>
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 
-#define WIDTH 128
-#define HEIGHT 64
+// Maior painel suportado pelo controlador (limita os buffers de transporte)
+#define SSD1306_MAX_WIDTH 128
+#define SSD1306_MAX_HEIGHT 64
+// Número máximo de displays em um ssd1306_group_t
+#define SSD1306_MAX_DISPLAYS 4
+
+// Custo aproximado, em bytes no barramento, de abrir uma nova janela de envio
+#define SSD1306_SPAN_OVERHEAD 10
+// Número máximo de janelas por transferência de diferenças
+#define SSD1306_MAX_WINDOWS 8
+// Capacidade de uma sequência de comandos enviada em uma única transação
+#define SSD1306_CMD_STREAM_MAX 32
+
+// Tamanhos dos buffers fornecidos pelo chamador para um painel w x h:
+// framebuffer (e cópia sombra) com o byte de controle inicial e buffer auxiliar
+// com espaço para o cabeçalho de cada janela
+#define SSD1306_BUFSIZE(w, h) ((w) * ((h) / 8) + 1)
+#define SSD1306_SCRATCH_SIZE(w, h) (SSD1306_BUFSIZE(w, h) + SSD1306_MAX_WINDOWS * 8)
 
 typedef enum {
   SET_CONTRAST = 0x81,
@@ -22,9 +41,53 @@ typedef enum {
   SET_DISP_CLK_DIV = 0xD5,
   SET_PRECHARGE = 0xD9,
   SET_VCOM_DESEL = 0xDB,
-  SET_CHARGE_PUMP = 0x8D
+  SET_CHARGE_PUMP = 0x8D,
+  // Rolagem por hardware: horizontal contínua (6 argumentos), vertical e
+  // horizontal (5) e área da rolagem vertical (2). Com a rolagem ativa a
+  // GDDRAM não pode ser escrita; desativar exige reescrevê-la
+  SET_HSCROLL_RIGHT = 0x26,
+  SET_HSCROLL_LEFT = 0x27,
+  SET_VHSCROLL_RIGHT = 0x29,
+  SET_VHSCROLL_LEFT = 0x2A,
+  SET_SCROLL_OFF = 0x2E,
+  SET_SCROLL_ON = 0x2F,
+  SET_VSCROLL_AREA = 0xA3
 } ssd1306_command_t;
 
+typedef struct {
+  const uint8_t *data;
+  size_t len;
+} ssd1306_segment_t;
+
+typedef void (*ssd1306_done_cb_t)(void *arg);
+typedef void (*ssd1306_xfer_cb_t)(void *arg, bool ok);
+
+// Interface de transporte: isola as chamadas ao HAL para que o driver possa ser
+// usado com outro barramento ou com um mock no host. write_async recebe uma
+// sequência de transações (cada uma começa com o byte de controle), deve
+// copiá-las antes de retornar e chamar done ao fim do envio, com ok = false se
+// o barramento abortou (NACK, perda de arbitragem), ou retornar false sem
+// iniciar nada (o quadro fica para o próximo envio); pode ser NULL, e então os
+// envios assíncronos usam write.
+typedef struct {
+  void (*write)(void *ctx, uint8_t address, const uint8_t *src, size_t len);
+  bool (*write_async)(void *ctx, uint8_t address, const ssd1306_segment_t *segs, size_t count,
+                      ssd1306_xfer_cb_t done, void *arg);
+  bool (*busy)(void *ctx);
+} ssd1306_transport_t;
+
+typedef struct {
+  uint32_t frames_sent, frames_skipped;
+  uint32_t bytes_sent, bytes_saved;
+  uint32_t transactions, bus_bytes; // transações I2C e bytes no barramento (inclui endereço)
+  uint32_t transfer_errors;         // transferências assíncronas abortadas, reenviadas depois
+} ssd1306_stats_t;
+
+typedef struct {
+  uint8_t buf[SSD1306_CMD_STREAM_MAX + 1];
+  size_t len;
+} ssd1306_cmd_stream_t;
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
@@ -32,12 +95,74 @@ typedef struct {
   uint8_t *ram_buffer;
   size_t bufsize;
   uint8_t port_buffer[2];
+  uint8_t *scratch_buffer;
+  uint8_t dirty_x0, dirty_x1, dirty_p0, dirty_p1; // região alterada (colunas/páginas); x0 > x1 indica limpo
+  uint8_t *shadow_buffer;                          // cópia do último quadro enviado (opcional)
+  bool shadow_valid;
+  uint8_t xfer_x0, xfer_x1, xfer_p0, xfer_p1;      // região da última transferência assíncrona
+  volatile bool xfer_failed;                       // ela abortou: reenviar no próximo envio
+  ssd1306_stats_t stats;
+  const ssd1306_transport_t *transport;
+  void *transport_ctx;
+  ssd1306_done_cb_t on_done;
+  void *on_done_arg;
 } ssd1306_t;
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+// Retângulo inclusivo em coordenadas da tela; vazio se x0 > x1 ou y0 > y1
+typedef struct {
+  int16_t x0, y0, x1, y1;
+} ssd1306_area_t;
+
+// Janela de desenho: coordenadas relativas à origem (ox, oy), recortadas pela
+// área visível clip (janela ∩ tela, ou ∩ janela mãe em ssd1306_view_sub).
+// O recorte é feito uma vez por primitiva, não por pixel.
+typedef struct {
+  ssd1306_t *ssd;
+  int16_t ox, oy;
+  ssd1306_area_t clip;
+} ssd1306_view_t;
+
+// Displays enviados em rodízio: cada chamada de ssd1306_group_flush inicia o
+// envio em todos os barramentos livres, então displays em portas I2C
+// diferentes transmitem ao mesmo tempo
+typedef struct {
+  ssd1306_t *displays[SSD1306_MAX_DISPLAYS];
+  size_t count;
+  size_t next;  // primeiro display da próxima rodada
+} ssd1306_group_t;
+
+// ram_buffer: SSD1306_BUFSIZE(width, height) bytes; scratch_buffer:
+// SSD1306_SCRATCH_SIZE(width, height) bytes. Ambos pertencem ao chamador
+void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c,
+                  uint8_t *ram_buffer, uint8_t *scratch_buffer);
+void ssd1306_init_canvas(ssd1306_t *ssd, uint8_t width, uint8_t height, uint8_t *ram_buffer);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+void ssd1306_cmd_begin(ssd1306_cmd_stream_t *cs);
+void ssd1306_cmd_push(ssd1306_cmd_stream_t *cs, uint8_t command);
+void ssd1306_cmd_send(ssd1306_t *ssd, ssd1306_cmd_stream_t *cs);
 void ssd1306_send_data(ssd1306_t *ssd);
+void ssd1306_send_dirty(ssd1306_t *ssd);
+void ssd1306_mark_dirty(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1);
+void ssd1306_enable_shadow(ssd1306_t *ssd, uint8_t *shadow_buffer);
+void ssd1306_send_diff(ssd1306_t *ssd);
+const ssd1306_stats_t *ssd1306_get_stats(const ssd1306_t *ssd);
+void ssd1306_reset_stats(ssd1306_t *ssd);
+bool ssd1306_send_data_async(ssd1306_t *ssd);
+bool ssd1306_send_dirty_async(ssd1306_t *ssd);
+bool ssd1306_send_diff_async(ssd1306_t *ssd);
+void ssd1306_send_areas(ssd1306_t *ssd, const ssd1306_area_t *areas, size_t count);
+bool ssd1306_send_areas_async(ssd1306_t *ssd, const ssd1306_area_t *areas, size_t count);
+bool ssd1306_is_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+void ssd1306_set_callback(ssd1306_t *ssd, ssd1306_done_cb_t callback, void *arg);
+void ssd1306_set_transport(ssd1306_t *ssd, const ssd1306_transport_t *transport, void *ctx);
+
+void ssd1306_group_init(ssd1306_group_t *group);
+bool ssd1306_group_add(ssd1306_group_t *group, ssd1306_t *ssd);
+size_t ssd1306_group_flush(ssd1306_group_t *group);
+bool ssd1306_group_busy(ssd1306_group_t *group);
+void ssd1306_group_wait(ssd1306_group_t *group);
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
@@ -46,4 +171,19 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+void ssd1306_view_init(ssd1306_view_t *view, ssd1306_t *ssd, int x, int y, int w, int h);
+void ssd1306_view_sub(ssd1306_view_t *view, const ssd1306_view_t *parent, int x, int y, int w, int h);
+bool ssd1306_view_empty(const ssd1306_view_t *view);
+void ssd1306_view_invalidate(ssd1306_view_t *view);
+void ssd1306_view_pixel(ssd1306_view_t *view, int x, int y, bool value);
+void ssd1306_view_fill(ssd1306_view_t *view, bool value);
+void ssd1306_view_rect(ssd1306_view_t *view, int x, int y, int w, int h, bool value, bool fill);
+void ssd1306_view_hline(ssd1306_view_t *view, int x0, int x1, int y, bool value);
+void ssd1306_view_vline(ssd1306_view_t *view, int x, int y0, int y1, bool value);
+void ssd1306_view_line(ssd1306_view_t *view, int x0, int y0, int x1, int y1, bool value);
+void ssd1306_view_draw_char(ssd1306_view_t *view, char c, int x, int y);
+void ssd1306_view_draw_string(ssd1306_view_t *view, const char *str, int x, int y);
+
+#endif // SSD1306_H
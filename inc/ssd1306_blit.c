@@ -0,0 +1,144 @@
+#include "ssd1306_blit.h"
+
+// Operação interna de apagamento: zera onde a fonte é 1
+#define SSD1306_BLIT_CLEAR ((ssd1306_blit_mode_t)-1)
+
+// 8 linhas da coluna do bitmap a partir da linha r (pode ser negativa, até -7);
+// linhas fora do bitmap valem 0
+static uint8_t ssd1306_column_bits(const uint8_t *col, uint8_t pages, int r) {
+  if (r < 0)
+    return col[0] << -r;
+  uint8_t p = r >> 3;
+  uint8_t shift = r & 7;
+  uint8_t lo = p < pages ? col[p] : 0;
+  if (shift == 0)
+    return lo;
+  uint8_t hi = p + 1 < pages ? col[p + 1] : 0;
+  return (lo >> shift) | (hi << (8 - shift));
+}
+
+// Percorre a área visível coluna a coluna e, em cada coluna, as páginas de
+// destino que ela cruza: cada byte do framebuffer recebe os 8 bits do bitmap
+// já deslocados para a página, limitados às linhas visíveis (m). O recorte é
+// calculado uma vez para todo o bitmap.
+static void ssd1306_blit_area(ssd1306_t *ssd, const ssd1306_bitmap_t *bmp, const ssd1306_bitmap_t *mask, int x, int y,
+                              const ssd1306_area_t *clip, ssd1306_blit_mode_t mode) {
+  int cx0 = x > clip->x0 ? x : clip->x0;
+  int cx1 = x + bmp->width - 1 < clip->x1 ? x + bmp->width - 1 : clip->x1;
+  int cy0 = y > clip->y0 ? y : clip->y0;
+  int cy1 = y + bmp->height - 1 < clip->y1 ? y + bmp->height - 1 : clip->y1;
+  if (cx0 > cx1 || cy0 > cy1)
+    return;
+
+  uint8_t src_pages = SSD1306_BITMAP_PAGES(bmp->height);
+  uint8_t p0 = cy0 >> 3;
+  uint8_t p1 = cy1 >> 3;
+  uint8_t top = 0xFF << (cy0 & 7);
+  uint8_t bottom = 0xFF >> (7 - (cy1 & 7));
+
+  ssd1306_mark_dirty(ssd, cx0, cy0, cx1, cy1);
+
+  for (int cx = cx0; cx <= cx1; ++cx) {
+    const uint8_t *src = &bmp->data[(cx - x) * src_pages];
+    const uint8_t *msk = mask ? &mask->data[(cx - x) * src_pages] : NULL;
+    uint8_t *col = &ssd->ram_buffer[cx * ssd->pages + 1];
+
+    for (uint8_t p = p0; p <= p1; ++p) {
+      uint8_t m = 0xFF;
+      if (p == p0) m &= top;
+      if (p == p1) m &= bottom;
+
+      int r = p * 8 - y;
+      uint8_t s = ssd1306_column_bits(src, src_pages, r);
+      uint8_t d = col[p];
+
+      switch (mode) {
+        case SSD1306_BLIT_COPY:
+          d = (d & ~m) | (s & m);
+          break;
+        case SSD1306_BLIT_OR:
+          d |= s & m;
+          break;
+        case SSD1306_BLIT_AND:
+          d &= s | ~m;
+          break;
+        case SSD1306_BLIT_XOR:
+          d ^= s & m;
+          break;
+        case SSD1306_BLIT_MASK:
+          m &= msk ? ssd1306_column_bits(msk, src_pages, r) : 0xFF;
+          d = (d & ~m) | (s & m);
+          break;
+        default:  // SSD1306_BLIT_CLEAR
+          d &= ~(s & m);
+          break;
+      }
+      col[p] = d;
+    }
+  }
+}
+
+void ssd1306_blit(ssd1306_t *ssd, const ssd1306_bitmap_t *bmp, const ssd1306_bitmap_t *mask, int x, int y,
+                  ssd1306_blit_mode_t mode) {
+  ssd1306_area_t screen = { 0, 0, ssd->width - 1, ssd->height - 1 };
+  ssd1306_blit_area(ssd, bmp, mask, x, y, &screen, mode);
+}
+
+void ssd1306_view_blit(ssd1306_view_t *view, const ssd1306_bitmap_t *bmp, const ssd1306_bitmap_t *mask, int x, int y,
+                       ssd1306_blit_mode_t mode) {
+  ssd1306_blit_area(view->ssd, bmp, mask, view->ox + x, view->oy + y, &view->clip, mode);
+}
+
+void ssd1306_sprite_init(ssd1306_sprite_t *sprite, const ssd1306_bitmap_t *bitmap, const ssd1306_bitmap_t *mask,
+                         ssd1306_blit_mode_t mode) {
+  sprite->bitmap = bitmap;
+  sprite->mask = mask;
+  sprite->mode = mode;
+  sprite->x = 0;
+  sprite->y = 0;
+  sprite->visible = false;
+}
+
+void ssd1306_sprite_show(ssd1306_view_t *view, ssd1306_sprite_t *sprite, int x, int y) {
+  if (sprite->visible)
+    ssd1306_sprite_hide(view, sprite);
+  ssd1306_view_blit(view, sprite->bitmap, sprite->mask, x, y, sprite->mode);
+  sprite->x = x;
+  sprite->y = y;
+  sprite->visible = true;
+}
+
+void ssd1306_sprite_hide(ssd1306_view_t *view, ssd1306_sprite_t *sprite) {
+  if (!sprite->visible)
+    return;
+
+  const ssd1306_bitmap_t *bmp = sprite->bitmap;
+  switch (sprite->mode) {
+    case SSD1306_BLIT_XOR:
+      ssd1306_view_blit(view, bmp, NULL, sprite->x, sprite->y, SSD1306_BLIT_XOR);
+      break;
+    case SSD1306_BLIT_OR:
+      ssd1306_view_blit(view, bmp, NULL, sprite->x, sprite->y, SSD1306_BLIT_CLEAR);
+      break;
+    case SSD1306_BLIT_MASK:
+      if (sprite->mask) {
+        ssd1306_view_blit(view, sprite->mask, NULL, sprite->x, sprite->y, SSD1306_BLIT_CLEAR);
+        break;
+      }
+      // fall through
+    default:
+      ssd1306_view_rect(view, sprite->x, sprite->y, bmp->width, bmp->height, false, true);
+      break;
+  }
+  sprite->visible = false;
+}
+
+void ssd1306_sprite_move(ssd1306_view_t *view, ssd1306_sprite_t *sprite, int x, int y) {
+  if (sprite->visible && sprite->x == x && sprite->y == y)
+    return;
+  ssd1306_sprite_show(view, sprite, x, y);
+}
+
+void ssd1306_sprite_forget(ssd1306_sprite_t *sprite) {
+  sprite->visible = false;
+}
@@ -0,0 +1,50 @@
+#ifndef SSD1306_BLIT_H
+#define SSD1306_BLIT_H
+
+#include "ssd1306.h"
+
+// Bitmap de 1 bit por pixel no mesmo formato do framebuffer: coluna a coluna,
+// (height + 7) / 8 bytes por coluna, bit 0 na linha de cima. Bits além de
+// height no último byte são ignorados.
+typedef struct {
+  uint8_t width, height;
+  const uint8_t *data;
+} ssd1306_bitmap_t;
+
+#define SSD1306_BITMAP_PAGES(h) (((h) + 7) / 8)
+
+typedef enum {
+  SSD1306_BLIT_COPY,  // substitui a área pelo bitmap
+  SSD1306_BLIT_OR,    // acende os pixels 1 do bitmap
+  SSD1306_BLIT_AND,   // apaga onde o bitmap é 0
+  SSD1306_BLIT_XOR,   // inverte onde o bitmap é 1 (repetir desfaz)
+  SSD1306_BLIT_MASK,  // COPY só onde a máscara é 1; transparente no resto
+} ssd1306_blit_mode_t;
+
+// mask só é usada em SSD1306_BLIT_MASK (mesmo tamanho do bitmap)
+void ssd1306_blit(ssd1306_t *ssd, const ssd1306_bitmap_t *bmp, const ssd1306_bitmap_t *mask, int x, int y,
+                  ssd1306_blit_mode_t mode);
+void ssd1306_view_blit(ssd1306_view_t *view, const ssd1306_bitmap_t *bmp, const ssd1306_bitmap_t *mask, int x, int y,
+                       ssd1306_blit_mode_t mode);
+
+// Sprite: lembra onde foi desenhado para se apagar no lugar. Em XOR o
+// apagamento restaura exatamente o fundo, desde que nada tenha sido desenhado
+// por cima entre show e hide; nos demais modos a área ocupada (máscara, pixels
+// acesos em OR ou o retângulo inteiro) é apagada.
+typedef struct {
+  const ssd1306_bitmap_t *bitmap;
+  const ssd1306_bitmap_t *mask;
+  ssd1306_blit_mode_t mode;
+  int16_t x, y;   // posição desenhada
+  bool visible;
+} ssd1306_sprite_t;
+
+void ssd1306_sprite_init(ssd1306_sprite_t *sprite, const ssd1306_bitmap_t *bitmap, const ssd1306_bitmap_t *mask,
+                         ssd1306_blit_mode_t mode);
+void ssd1306_sprite_show(ssd1306_view_t *view, ssd1306_sprite_t *sprite, int x, int y);
+void ssd1306_sprite_hide(ssd1306_view_t *view, ssd1306_sprite_t *sprite);
+void ssd1306_sprite_move(ssd1306_view_t *view, ssd1306_sprite_t *sprite, int x, int y);
+// O framebuffer foi limpo ou redesenhado por baixo: não há o que apagar
+void ssd1306_sprite_forget(ssd1306_sprite_t *sprite);
+
+#endif // SSD1306_BLIT_H
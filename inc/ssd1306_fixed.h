@@ -0,0 +1,100 @@
+#ifndef SSD1306_FIXED_H
+#define SSD1306_FIXED_H
+
+#include <string.h>
+#include "ssd1306.h"
+
+// Especialização em tempo de compilação para um painel de geometria fixa.
+// SSD1306_FIXED_DEFINE(nome, W, H) declara a instância `ssd1306_t nome`, seus
+// buffers estáticos e as funções de desenho nome_pixel, nome_fill,
+// nome_fill_rect, nome_rect, nome_hline e nome_vline, que operam direto sobre o
+// framebuffer da instância. Com W e H constantes o índice x * páginas + página
+// dobra em constantes, os limites viram comparações com imediatos e os laços
+// têm contagem conhecida, que o compilador desenrola ou vetoriza. Envio, diff
+// e texto continuam pelas funções genéricas sobre &nome.
+//
+// O armazenamento é alinhado a 4 bytes e os pixels começam no byte 4:
+// ram_buffer aponta para o byte de controle 0x40 logo antes deles.
+
+// Marca a região suja já em colunas/páginas, sem a chamada a ssd1306_mark_dirty
+static inline void ssd1306_fixed_mark(ssd1306_t *ssd, uint8_t x0, uint8_t p0, uint8_t x1, uint8_t p1) {
+  if (x0 < ssd->dirty_x0) ssd->dirty_x0 = x0;
+  if (x1 > ssd->dirty_x1) ssd->dirty_x1 = x1;
+  if (p0 < ssd->dirty_p0) ssd->dirty_p0 = p0;
+  if (p1 > ssd->dirty_p1) ssd->dirty_p1 = p1;
+}
+
+#define SSD1306_FIXED_DEFINE(name, W, H)                                                          \
+  _Static_assert((H) % 8 == 0 && (W) <= SSD1306_MAX_WIDTH && (H) <= SSD1306_MAX_HEIGHT,           \
+                 "geometria SSD1306 inválida");                                                   \
+  ssd1306_t name;                                                                                 \
+  static uint8_t name##_storage[SSD1306_BUFSIZE(W, H) + 3] __attribute__((aligned(4)));           \
+  static uint8_t name##_shadow[SSD1306_BUFSIZE(W, H) + 3] __attribute__((aligned(4)));            \
+  static uint8_t name##_scratch[SSD1306_SCRATCH_SIZE(W, H)] __attribute__((aligned(4)));          \
+                                                                                                  \
+  static inline void name##_init(bool external_vcc, uint8_t address, i2c_inst_t *i2c) {           \
+    ssd1306_init(&name, W, H, external_vcc, address, i2c, &name##_storage[3], name##_scratch);    \
+  }                                                                                               \
+                                                                                                  \
+  static inline void name##_enable_shadow(void) {                                                 \
+    ssd1306_enable_shadow(&name, &name##_shadow[3]);                                              \
+  }                                                                                               \
+                                                                                                  \
+  static inline void name##_pixel(uint8_t x, uint8_t y, bool value) {                             \
+    if (x >= (W) || y >= (H))                                                                     \
+      return;                                                                                     \
+    uint8_t *b = &name##_storage[4 + x * ((H) / 8) + (y >> 3)];                                   \
+    uint8_t bit = 1u << (y & 7);                                                                  \
+    *b = value ? (*b | bit) : (*b & ~bit);                                                        \
+    ssd1306_fixed_mark(&name, x, y >> 3, x, y >> 3);                                              \
+  }                                                                                               \
+                                                                                                  \
+  static inline void name##_fill(bool value) {                                                    \
+    memset(&name##_storage[4], value ? 0xFF : 0x00, (W) * ((H) / 8));                             \
+    ssd1306_fixed_mark(&name, 0, 0, (W) - 1, (H) / 8 - 1);                                        \
+  }                                                                                               \
+                                                                                                  \
+  /* Mesmo algoritmo por página de ssd1306_fill_area, com o passo de coluna constante */          \
+  static inline void name##_fill_rect(int x0, int y0, int x1, int y1, bool value) {               \
+    if (x0 < 0) x0 = 0;                                                                           \
+    if (y0 < 0) y0 = 0;                                                                           \
+    if (x1 >= (W)) x1 = (W) - 1;                                                                  \
+    if (y1 >= (H)) y1 = (H) - 1;                                                                  \
+    if (x0 > x1 || y0 > y1)                                                                       \
+      return;                                                                                     \
+    uint8_t p0 = y0 >> 3, p1 = y1 >> 3;                                                           \
+    uint8_t top = 0xFF << (y0 & 7);                                                               \
+    uint8_t bottom = 0xFF >> (7 - (y1 & 7));                                                      \
+    uint8_t solid = value ? 0xFF : 0x00;                                                          \
+    if (p0 == p1)                                                                                 \
+      top &= bottom;                                                                              \
+    ssd1306_fixed_mark(&name, x0, p0, x1, p1);                                                    \
+    uint8_t *col = &name##_storage[4 + x0 * ((H) / 8)];                                           \
+    for (int x = x0; x <= x1; ++x, col += (H) / 8) {                                              \
+      col[p0] = value ? (col[p0] | top) : (col[p0] & ~top);                                       \
+      if (p0 == p1)                                                                               \
+        continue;                                                                                 \
+      for (uint8_t p = p0 + 1; p < p1; ++p)                                                       \
+        col[p] = solid;                                                                           \
+      col[p1] = value ? (col[p1] | bottom) : (col[p1] & ~bottom);                                 \
+    }                                                                                             \
+  }                                                                                               \
+                                                                                                  \
+  static inline void name##_rect(int x, int y, int w, int h, bool value) {                        \
+    if (w <= 0 || h <= 0)                                                                         \
+      return;                                                                                     \
+    name##_fill_rect(x, y, x + w - 1, y, value);                                                  \
+    name##_fill_rect(x, y + h - 1, x + w - 1, y + h - 1, value);                                  \
+    name##_fill_rect(x, y, x, y + h - 1, value);                                                  \
+    name##_fill_rect(x + w - 1, y, x + w - 1, y + h - 1, value);                                  \
+  }                                                                                               \
+                                                                                                  \
+  static inline void name##_hline(int x0, int x1, int y, bool value) {                            \
+    name##_fill_rect(x0, y, x1, y, value);                                                        \
+  }                                                                                               \
+                                                                                                  \
+  static inline void name##_vline(int x, int y0, int y1, bool value) {                            \
+    name##_fill_rect(x, y0, x, y1, value);                                                        \
+  }
+
+#endif // SSD1306_FIXED_H
@@ -0,0 +1,148 @@
+#include "ssd1306_i2c.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+typedef struct {
+  i2c_inst_t *i2c;
+  int dma_channel;
+  volatile bool dma_busy;
+  volatile bool in_flight;  // até o STOP ou o abort da transferência
+  ssd1306_xfer_cb_t done;
+  void *done_arg;
+  uint32_t abort_source;    // IC_TX_ABRT_SOURCE do último abort, para depuração
+  uint16_t dma_buffer[SSD1306_I2C_DMA_WORDS];
+} ssd1306_i2c_ctx_t;
+
+// Um contexto por controlador I2C: displays no mesmo barramento compartilham o
+// buffer de DMA e o estado de ocupado
+static ssd1306_i2c_ctx_t i2c_ctx[2] = {
+  { .i2c = i2c0, .dma_channel = -1 },
+  { .i2c = i2c1, .dma_channel = -1 },
+};
+static bool irq_installed = false;
+static bool i2c_irq_installed[2] = { false, false };
+
+void *ssd1306_i2c_context(i2c_inst_t *i2c) {
+  return &i2c_ctx[i2c_get_index(i2c)];
+}
+
+static void ssd1306_i2c_write(void *ctx, uint8_t address, const uint8_t *src, size_t len) {
+  ssd1306_i2c_ctx_t *c = ctx;
+  i2c_write_blocking(c->i2c, address, src, len, false);
+}
+
+static bool ssd1306_i2c_busy(void *ctx) {
+  ssd1306_i2c_ctx_t *c = ctx;
+  i2c_hw_t *hw = i2c_get_hw(c->i2c);
+  // O fim do DMA só garante que os bytes chegaram ao FIFO; o barramento fica
+  // ocupado até o FIFO esvaziar e o STOP ser emitido
+  return c->in_flight ||
+         !(hw->status & I2C_IC_STATUS_TFE_BITS) ||
+         (hw->status & I2C_IC_STATUS_MST_ACTIVITY_BITS);
+}
+
+// O fim do DMA só garante que os bytes chegaram ao FIFO: a conclusão fica
+// para a interrupção da porta, no STOP ou no abort. Um abort no meio (NACK,
+// perda de arbitragem) esvazia o FIFO e descarta as escritas seguintes, então
+// o DMA termina de qualquer forma
+#define SSD1306_I2C_END_BITS (I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS)
+
+static void ssd1306_i2c_dma_irq(void) {
+  for (uint i = 0; i < 2; ++i) {
+    ssd1306_i2c_ctx_t *c = &i2c_ctx[i];
+    if (c->dma_channel < 0 || !dma_channel_get_irq0_status(c->dma_channel))
+      continue;
+    dma_channel_acknowledge_irq0(c->dma_channel);
+    c->dma_busy = false;
+    // Se o STOP ou o abort já ocorreu, a interrupção da porta dispara em seguida
+    i2c_get_hw(c->i2c)->intr_mask = SSD1306_I2C_END_BITS;
+  }
+}
+
+static void ssd1306_i2c_end_irq(void) {
+  for (uint i = 0; i < 2; ++i) {
+    ssd1306_i2c_ctx_t *c = &i2c_ctx[i];
+    i2c_hw_t *hw = i2c_get_hw(c->i2c);
+    if (!c->in_flight || c->dma_busy || !(hw->intr_stat & SSD1306_I2C_END_BITS))
+      continue;
+    // Só depois do DMA: limpar o abort antes liberaria o FIFO para o resto
+    // da sequência, enviado sem START
+    bool ok = !(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS);
+    if (!ok) {
+      c->abort_source = hw->tx_abrt_source;
+      (void)hw->clr_tx_abrt;
+    }
+    (void)hw->clr_stop_det;
+    hw->intr_mask = 0;
+    if (c->done)
+      c->done(c->done_arg, ok);
+    c->in_flight = false;
+  }
+}
+
+// Codifica todas as transações em uma única sequência para o IC_DATA_CMD:
+// RESTART no primeiro byte de cada transação seguinte e STOP no último byte.
+// O DMA é cadenciado pelo DREQ de TX da porta, sem intervenção da CPU.
+static bool ssd1306_i2c_write_async(void *ctx, uint8_t address, const ssd1306_segment_t *segs, size_t count,
+                                    ssd1306_xfer_cb_t done, void *arg) {
+  ssd1306_i2c_ctx_t *c = ctx;
+  size_t n = 0;
+
+  if (count == 0 || ssd1306_i2c_busy(c))
+    return false;
+
+  for (size_t s = 0; s < count; ++s) {
+    if (n + segs[s].len > SSD1306_I2C_DMA_WORDS)
+      return false;
+    for (size_t i = 0; i < segs[s].len; ++i)
+      c->dma_buffer[n++] = segs[s].data[i];
+    if (s > 0)
+      c->dma_buffer[n - segs[s].len] |= I2C_IC_DATA_CMD_RESTART_BITS;
+  }
+  c->dma_buffer[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS;
+
+  if (c->dma_channel < 0) {
+    c->dma_channel = dma_claim_unused_channel(true);
+    dma_channel_set_irq0_enabled(c->dma_channel, true);
+    if (!irq_installed) {
+      irq_add_shared_handler(DMA_IRQ_0, ssd1306_i2c_dma_irq, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+      irq_set_enabled(DMA_IRQ_0, true);
+      irq_installed = true;
+    }
+  }
+
+  i2c_hw_t *hw = i2c_get_hw(c->i2c);
+  hw->enable = 0;
+  hw->tar = address;
+  hw->enable = 1;
+  hw->intr_mask = 0;
+  (void)hw->clr_tx_abrt;
+  (void)hw->clr_stop_det;
+  // A máscara vem do reset com interrupções habilitadas: zerada antes de
+  // habilitar a IRQ da porta
+  uint index = i2c_get_index(c->i2c);
+  if (!i2c_irq_installed[index]) {
+    irq_set_exclusive_handler(I2C0_IRQ + index, ssd1306_i2c_end_irq);
+    irq_set_enabled(I2C0_IRQ + index, true);
+    i2c_irq_installed[index] = true;
+  }
+
+  c->done = done;
+  c->done_arg = arg;
+  c->dma_busy = true;
+  c->in_flight = true;
+
+  dma_channel_config cfg = dma_channel_get_default_config(c->dma_channel);
+  channel_config_set_transfer_data_size(&cfg, DMA_SIZE_16);
+  channel_config_set_read_increment(&cfg, true);
+  channel_config_set_write_increment(&cfg, false);
+  channel_config_set_dreq(&cfg, i2c_get_dreq(c->i2c, true));
+  dma_channel_configure(c->dma_channel, &cfg, &hw->data_cmd, c->dma_buffer, n, true);
+  return true;
+}
+
+const ssd1306_transport_t ssd1306_i2c_transport = {
+  .write = ssd1306_i2c_write,
+  .write_async = ssd1306_i2c_write_async,
+  .busy = ssd1306_i2c_busy,
+};
@@ -0,0 +1,15 @@
+#ifndef SSD1306_I2C_H
+#define SSD1306_I2C_H
+
+#include "ssd1306.h"
+
+// Palavras de 16 bits (byte + bits STOP/RESTART do IC_DATA_CMD) reservadas por
+// porta I2C para a transferência via DMA: um quadro completo mais o cabeçalho
+// de cada janela do maior painel suportado
+#define SSD1306_I2C_DMA_WORDS SSD1306_SCRATCH_SIZE(SSD1306_MAX_WIDTH, SSD1306_MAX_HEIGHT)
+
+extern const ssd1306_transport_t ssd1306_i2c_transport;
+
+void *ssd1306_i2c_context(i2c_inst_t *i2c);
+
+#endif // SSD1306_I2C_H
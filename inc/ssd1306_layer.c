@@ -0,0 +1,87 @@
+#include "ssd1306_layer.h"
+#include <string.h>
+
+// Acesso por palavra a buffers de bytes sem violar o aliasing estrito
+typedef uint32_t __attribute__((may_alias)) ssd1306_word_t;
+
+void ssd1306_layer_init(ssd1306_layer_t *layer, uint8_t width, uint8_t height, uint32_t *storage) {
+  ssd1306_init_canvas(&layer->canvas, width, height, (uint8_t *)storage + 3);
+}
+
+void ssd1306_layer_clear(ssd1306_layer_t *layer) {
+  ssd1306_fill(&layer->canvas, false);
+}
+
+static bool ssd1306_layer_fits(const ssd1306_t *ssd, const ssd1306_layer_t *layer) {
+  return layer->canvas.width == ssd->width && layer->canvas.height == ssd->height;
+}
+
+void ssd1306_layer_copy(ssd1306_t *ssd, const ssd1306_layer_t *layer) {
+  if (!ssd1306_layer_fits(ssd, layer))
+    return;
+  memcpy(&ssd->ram_buffer[1], &layer->canvas.ram_buffer[1], ssd->bufsize - 1);
+  ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+}
+
+// Os pixels da camada estão sempre alinhados; com o framebuffer também
+// alinhado (ex.: SSD1306_FIXED_DEFINE) a combinação é feita por palavra
+void ssd1306_layer_or(ssd1306_t *ssd, const ssd1306_layer_t *layer) {
+  if (!ssd1306_layer_fits(ssd, layer))
+    return;
+
+  uint8_t *dst = &ssd->ram_buffer[1];
+  const uint8_t *src = &layer->canvas.ram_buffer[1];
+  size_t len = ssd->bufsize - 1;
+  size_t i = 0;
+
+  if (((uintptr_t)dst & 3) == 0) {
+    ssd1306_word_t *d = (ssd1306_word_t *)dst;
+    const ssd1306_word_t *s = (const ssd1306_word_t *)src;
+    for (; i + 4 <= len; i += 4)
+      *d++ |= *s++;
+  }
+  for (; i < len; ++i)
+    dst[i] |= src[i];
+  ssd1306_mark_dirty(ssd, 0, 0, ssd->width - 1, ssd->height - 1);
+}
+
+void ssd1306_layer_compose(ssd1306_t *ssd, const ssd1306_layer_t *const *layers, size_t count) {
+  if (count == 0) {
+    ssd1306_fill(ssd, false);
+    return;
+  }
+  ssd1306_layer_copy(ssd, layers[0]);
+  for (size_t i = 1; i < count; ++i)
+    ssd1306_layer_or(ssd, layers[i]);
+}
+
+void ssd1306_layer_restore(ssd1306_t *ssd, const ssd1306_layer_t *layer, int x, int y, int w, int h) {
+  if (!ssd1306_layer_fits(ssd, layer) || w <= 0 || h <= 0)
+    return;
+
+  int x0 = x < 0 ? 0 : x;
+  int y0 = y < 0 ? 0 : y;
+  int x1 = x + w - 1 < ssd->width ? x + w - 1 : ssd->width - 1;
+  int y1 = y + h - 1 < ssd->height ? y + h - 1 : ssd->height - 1;
+  if (x0 > x1 || y0 > y1)
+    return;
+
+  uint8_t p0 = y0 >> 3;
+  uint8_t p1 = y1 >> 3;
+  uint8_t top = 0xFF << (y0 & 7);
+  uint8_t bottom = 0xFF >> (7 - (y1 & 7));
+
+  ssd1306_mark_dirty(ssd, x0, y0, x1, y1);
+
+  for (int cx = x0; cx <= x1; ++cx) {
+    size_t offset = cx * ssd->pages + 1;
+    uint8_t *dst = &ssd->ram_buffer[offset];
+    const uint8_t *src = &layer->canvas.ram_buffer[offset];
+    for (uint8_t p = p0; p <= p1; ++p) {
+      uint8_t m = 0xFF;
+      if (p == p0) m &= top;
+      if (p == p1) m &= bottom;
+      dst[p] = (dst[p] & ~m) | (src[p] & m);
+    }
+  }
+}
@@ -0,0 +1,30 @@
+#ifndef SSD1306_LAYER_H
+#define SSD1306_LAYER_H
+
+#include "ssd1306.h"
+
+// Camadas estáticas (bordas, rótulos, moldura): desenhadas uma vez com as
+// primitivas normais sobre layer->canvas e depois combinadas com o
+// framebuffer palavra a palavra. Camada e display têm a mesma geometria.
+
+// Armazenamento de uma camada w x h em palavras de 32 bits: os pixels ficam
+// alinhados a 4 bytes, logo após o byte de controle do canvas
+#define SSD1306_LAYER_WORDS(w, h) ((SSD1306_BUFSIZE(w, h) + 3 + 3) / 4)
+
+typedef struct {
+  ssd1306_t canvas;  // alvo de desenho; não deve ser enviado ao display
+} ssd1306_layer_t;
+
+void ssd1306_layer_init(ssd1306_layer_t *layer, uint8_t width, uint8_t height, uint32_t *storage);
+void ssd1306_layer_clear(ssd1306_layer_t *layer);
+
+// Substitui o framebuffer pela camada
+void ssd1306_layer_copy(ssd1306_t *ssd, const ssd1306_layer_t *layer);
+// Acende no framebuffer os pixels acesos da camada
+void ssd1306_layer_or(ssd1306_t *ssd, const ssd1306_layer_t *layer);
+// Primeira camada copiada, demais combinadas por OR
+void ssd1306_layer_compose(ssd1306_t *ssd, const ssd1306_layer_t *const *layers, size_t count);
+// Restaura o retângulo a partir da camada (ex.: apagar um sprite sobre o fundo)
+void ssd1306_layer_restore(ssd1306_t *ssd, const ssd1306_layer_t *layer, int x, int y, int w, int h);
+
+#endif // SSD1306_LAYER_H
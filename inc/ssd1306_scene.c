@@ -0,0 +1,394 @@
+#include "ssd1306_scene.h"
+#include <string.h>
+
+static const ssd1306_area_t empty_area = { 0, 0, -1, -1 };
+
+static bool area_empty(const ssd1306_area_t *a) {
+  return a->x0 > a->x1 || a->y0 > a->y1;
+}
+
+static bool area_overlap(const ssd1306_area_t *a, const ssd1306_area_t *b) {
+  return a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1;
+}
+
+static bool area_equal(const ssd1306_area_t *a, const ssd1306_area_t *b) {
+  if (area_empty(a) || area_empty(b))
+    return area_empty(a) && area_empty(b);
+  return a->x0 == b->x0 && a->y0 == b->y0 && a->x1 == b->x1 && a->y1 == b->y1;
+}
+
+static ssd1306_area_t area_union(const ssd1306_area_t *a, const ssd1306_area_t *b) {
+  return (ssd1306_area_t){
+    a->x0 < b->x0 ? a->x0 : b->x0, a->y0 < b->y0 ? a->y0 : b->y0,
+    a->x1 > b->x1 ? a->x1 : b->x1, a->y1 > b->y1 ? a->y1 : b->y1,
+  };
+}
+
+// Bytes de framebuffer (colunas x páginas) de uma área alinhada às páginas
+static size_t area_bytes(const ssd1306_area_t *a) {
+  return (size_t)(a->x1 - a->x0 + 1) * ((a->y1 - a->y0 + 1) / 8);
+}
+
+// Acrescenta uma área à lista mantendo as áreas disjuntas e alinhadas às
+// páginas (unidade de envio e de limpeza). Áreas que se tocam, ou cuja união
+// custa menos que uma janela a mais, são unidas; com a lista cheia, a nova
+// área é unida à que acrescenta menos bytes.
+static void damage_add(const ssd1306_t *ssd, ssd1306_area_t *list, size_t *count, ssd1306_area_t a) {
+  if (a.x0 < 0) a.x0 = 0;
+  if (a.y0 < 0) a.y0 = 0;
+  if (a.x1 > ssd->width - 1) a.x1 = ssd->width - 1;
+  if (a.y1 > ssd->height - 1) a.y1 = ssd->height - 1;
+  if (area_empty(&a))
+    return;
+  a.y0 &= ~7;
+  a.y1 |= 7;
+
+  for (;;) {
+    size_t merge = SIZE_MAX;
+    size_t cheapest = 0;
+    size_t cheapest_cost = SIZE_MAX;
+
+    for (size_t i = 0; i < *count; ++i) {
+      ssd1306_area_t u = area_union(&a, &list[i]);
+      if (area_overlap(&a, &list[i])) {
+        merge = i;
+        break;
+      }
+      size_t cost = area_bytes(&u) - area_bytes(&a) - area_bytes(&list[i]);
+      if (cost <= SSD1306_SPAN_OVERHEAD) {
+        merge = i;
+        break;
+      }
+      if (cost < cheapest_cost) {
+        cheapest_cost = cost;
+        cheapest = i;
+      }
+    }
+    if (merge == SIZE_MAX) {
+      if (*count < SSD1306_SCENE_MAX_DAMAGE) {
+        list[(*count)++] = a;
+        return;
+      }
+      merge = cheapest;
+    }
+    // A união pode alcançar outras áreas: repete até estabilizar
+    a = area_union(&a, &list[merge]);
+    list[merge] = list[--*count];
+  }
+}
+
+void ssd1306_scene_init(ssd1306_scene_t *scene, ssd1306_t *ssd) {
+  scene->ssd = ssd;
+  scene->count = 0;
+  scene->pending_count = 0;
+  scene->damage_count = 0;
+  memset(&scene->stats, 0, sizeof(scene->stats));
+  ssd1306_scene_damage(scene, 0, 0, ssd->width - 1, ssd->height - 1);
+}
+
+bool ssd1306_scene_add(ssd1306_scene_t *scene, ssd1306_node_t *node) {
+  if (scene->count == SSD1306_SCENE_MAX_NODES)
+    return false;
+  scene->nodes[scene->count++] = node;
+  node->dirty = true;
+  return true;
+}
+
+void ssd1306_scene_damage(ssd1306_scene_t *scene, int x0, int y0, int x1, int y1) {
+  damage_add(scene->ssd, scene->pending, &scene->pending_count, (ssd1306_area_t){ x0, y0, x1, y1 });
+}
+
+// Comprimento limitado a SSD1306_LABEL_MAX (strnlen não é C padrão)
+static size_t label_len(const char *text) {
+  size_t len = 0;
+  while (len < SSD1306_LABEL_MAX && text[len])
+    len++;
+  return len;
+}
+
+static void node_init(ssd1306_node_t *node, ssd1306_node_type_t type, int x, int y, int w, int h) {
+  memset(node, 0, sizeof(*node));
+  node->type = type;
+  node->box = (ssd1306_area_t){ x, y, x + w - 1, y + h - 1 };
+  node->shown = empty_area;
+  node->visible = true;
+  node->dirty = true;
+}
+
+void ssd1306_node_border(ssd1306_node_t *node, int x, int y, int w, int h, ssd1306_border_style_t style) {
+  node_init(node, SSD1306_NODE_BORDER, x, y, w, h);
+  node->border.style = style;
+}
+
+void ssd1306_node_label(ssd1306_node_t *node, int x, int y, const char *text) {
+  size_t len = label_len(text);
+  node_init(node, SSD1306_NODE_LABEL, x, y, 8 * len, 8);
+  memcpy(node->label.text, text, len);
+}
+
+void ssd1306_node_sprite(ssd1306_node_t *node, int x, int y, const ssd1306_bitmap_t *bitmap,
+                         const ssd1306_bitmap_t *mask, ssd1306_blit_mode_t mode) {
+  node_init(node, SSD1306_NODE_SPRITE, x, y, bitmap->width, bitmap->height);
+  node->sprite.bitmap = bitmap;
+  node->sprite.mask = mask;
+  node->sprite.mode = mode;
+}
+
+void ssd1306_node_bar(ssd1306_node_t *node, int x, int y, int w, int h, uint16_t max, bool vertical) {
+  node_init(node, SSD1306_NODE_BAR, x, y, w, h);
+  node->bar.max = max ? max : 1;
+  node->bar.vertical = vertical;
+}
+
+void ssd1306_node_plot(ssd1306_node_t *node, int x, int y, strip_chart_t *chart) {
+  node_init(node, SSD1306_NODE_PLOT, x, y, chart->width + 1, chart->height + 1);
+  node->plot.chart = chart;
+  node->plot.head = strip_chart_head(chart);
+}
+
+void ssd1306_node_move(ssd1306_node_t *node, int x, int y) {
+  if (x == node->box.x0 && y == node->box.y0)
+    return;
+  node->box.x1 += x - node->box.x0;
+  node->box.y1 += y - node->box.y0;
+  node->box.x0 = x;
+  node->box.y0 = y;
+  node->dirty = true;
+}
+
+void ssd1306_node_show(ssd1306_node_t *node, bool visible) {
+  if (node->visible != visible) {
+    node->visible = visible;
+    node->dirty = true;
+  }
+}
+
+void ssd1306_node_set_border(ssd1306_node_t *node, ssd1306_border_style_t style) {
+  if (node->border.style != style) {
+    node->border.style = style;
+    node->dirty = true;
+  }
+}
+
+void ssd1306_node_set_bitmap(ssd1306_node_t *node, const ssd1306_bitmap_t *bitmap, const ssd1306_bitmap_t *mask) {
+  node->sprite.bitmap = bitmap;
+  node->sprite.mask = mask;
+  node->box.x1 = node->box.x0 + bitmap->width - 1;
+  node->box.y1 = node->box.y0 + bitmap->height - 1;
+  node->dirty = true;
+}
+
+// Mesmo comprimento: só os caracteres diferentes; senão o rótulo inteiro
+void ssd1306_scene_set_label(ssd1306_scene_t *scene, ssd1306_node_t *node, const char *text) {
+  size_t len = label_len(text);
+  size_t old_len = strlen(node->label.text);
+
+  if (len != old_len) {
+    memset(node->label.text, 0, sizeof(node->label.text));
+    memcpy(node->label.text, text, len);
+    node->box.x1 = node->box.x0 + 8 * (int)len - 1;
+    node->dirty = true;
+    return;
+  }
+
+  size_t first = len, last = 0;
+  for (size_t i = 0; i < len; ++i) {
+    if (node->label.text[i] != text[i]) {
+      if (first == len) first = i;
+      last = i;
+    }
+  }
+  if (first == len)
+    return;
+  memcpy(node->label.text, text, len);
+  if (node->visible)
+    ssd1306_scene_damage(scene, node->box.x0 + 8 * first, node->box.y0, node->box.x0 + 8 * last + 7, node->box.y1);
+}
+
+// Área interna da barra: contorno de 1 pixel e 1 pixel de folga
+static int bar_span(const ssd1306_node_t *node) {
+  int w = node->box.x1 - node->box.x0 + 1;
+  int h = node->box.y1 - node->box.y0 + 1;
+  int span = (node->bar.vertical ? h : w) - 4;
+  return span > 0 ? span : 0;
+}
+
+// Só o trecho entre o fim antigo e o novo do preenchimento
+void ssd1306_scene_set_bar(ssd1306_scene_t *scene, ssd1306_node_t *node, uint16_t value) {
+  if (value > node->bar.max)
+    value = node->bar.max;
+  node->bar.value = value;
+  uint8_t length = (uint32_t)value * bar_span(node) / node->bar.max;
+  if (length == node->bar.length)
+    return;
+
+  int lo = length < node->bar.length ? length : node->bar.length;
+  int hi = length > node->bar.length ? length : node->bar.length;
+  node->bar.length = length;
+  if (!node->visible)
+    return;
+  const ssd1306_area_t *b = &node->box;
+  if (node->bar.vertical)
+    ssd1306_scene_damage(scene, b->x0 + 2, b->y1 - 1 - hi, b->x1 - 2, b->y1 - 2 - lo);
+  else
+    ssd1306_scene_damage(scene, b->x0 + 2 + lo, b->y0 + 2, b->x0 + 1 + hi, b->y1 - 2);
+}
+
+// Uma coluna do gráfico (índice da coluna no histórico) na tela
+static void plot_damage_column(ssd1306_scene_t *scene, const ssd1306_node_t *node, uint32_t i) {
+  int x = node->box.x0 + 1 + i % node->plot.chart->width;
+  ssd1306_scene_damage(scene, x, node->box.y0, x, node->box.y1 - 1);
+}
+
+// Mudam as colunas fechadas desde o último dano, a que vira a marca de
+// posição e a seguinte, que deixa de se ligar à anterior. Mais de uma volta
+// de atraso: a área interna inteira
+static void plot_sync(ssd1306_scene_t *scene, ssd1306_node_t *node) {
+  uint32_t head = strip_chart_head(node->plot.chart);
+  uint32_t from = node->plot.head;
+  if (head == from)
+    return;
+  node->plot.head = head;
+  // Oculto ou já marcado para redesenho inteiro: nada a acrescentar
+  if (!node->visible || node->dirty)
+    return;
+  if (head - from >= node->plot.chart->width) {
+    ssd1306_scene_damage(scene, node->box.x0 + 1, node->box.y0, node->box.x1, node->box.y1 - 1);
+    return;
+  }
+  for (uint32_t i = from; i < head + 2; ++i)
+    plot_damage_column(scene, node, i);
+}
+
+void ssd1306_scene_plot_push(ssd1306_scene_t *scene, ssd1306_node_t *node, uint16_t sample) {
+  if (strip_chart_push(node->plot.chart, sample))
+    plot_sync(scene, node);
+}
+
+// Pixels com coordenada par em cada lado, como draw_dotted_rect; percorre só
+// o trecho visível de cada lado
+static void draw_dotted(ssd1306_view_t *view, int w, int h) {
+  int x0 = view->clip.x0 - view->ox, x1 = view->clip.x1 - view->ox;
+  int y0 = view->clip.y0 - view->oy, y1 = view->clip.y1 - view->oy;
+
+  for (int x = x0 + (x0 & 1); x <= x1; x += 2) {
+    ssd1306_view_pixel(view, x, 0, true);
+    ssd1306_view_pixel(view, x, h - 1, true);
+  }
+  for (int y = y0 + (y0 & 1); y <= y1; y += 2) {
+    ssd1306_view_pixel(view, 0, y, true);
+    ssd1306_view_pixel(view, w - 1, y, true);
+  }
+}
+
+static void draw_bar(ssd1306_view_t *view, const ssd1306_node_t *node, int w, int h) {
+  ssd1306_view_rect(view, 0, 0, w, h, true, false);
+  if (!node->bar.length)
+    return;
+  if (node->bar.vertical)
+    ssd1306_view_rect(view, 2, h - 2 - node->bar.length, w - 4, node->bar.length, true, true);
+  else
+    ssd1306_view_rect(view, 2, 2, node->bar.length, h - 4, true, true);
+}
+
+// Eixos e, na área interna, as colunas do histórico que a área danificada
+// alcança
+static void draw_plot(ssd1306_view_t *view, const ssd1306_node_t *node, int w, int h) {
+  ssd1306_view_vline(view, 0, 0, h - 1, true);
+  ssd1306_view_hline(view, 0, w - 1, h - 1, true);
+
+  ssd1306_view_t inner;
+  ssd1306_view_sub(&inner, view, 1, 0, w - 1, h - 1);
+  if (!ssd1306_view_empty(&inner))
+    strip_chart_draw_range(node->plot.chart, &inner, inner.clip.x0 - inner.ox, inner.clip.x1 - inner.ox);
+}
+
+// view: origem no canto do nó, recortada pela área danificada
+static void draw_node(ssd1306_view_t *view, const ssd1306_node_t *node) {
+  int w = node->box.x1 - node->box.x0 + 1;
+  int h = node->box.y1 - node->box.y0 + 1;
+
+  switch (node->type) {
+    case SSD1306_NODE_BORDER:
+      if (node->border.style == SSD1306_BORDER_DOTTED) {
+        draw_dotted(view, w, h);
+      } else {
+        ssd1306_view_rect(view, 0, 0, w, h, true, false);
+        if (node->border.style == SSD1306_BORDER_DOUBLE && w > 4 && h > 4)
+          ssd1306_view_rect(view, 2, 2, w - 4, h - 4, true, false);
+      }
+      break;
+    case SSD1306_NODE_LABEL:
+      ssd1306_view_draw_string(view, node->label.text, 0, 0);
+      break;
+    case SSD1306_NODE_SPRITE:
+      ssd1306_view_blit(view, node->sprite.bitmap, node->sprite.mask, 0, 0, node->sprite.mode);
+      break;
+    case SSD1306_NODE_BAR:
+      draw_bar(view, node, w, h);
+      break;
+    case SSD1306_NODE_PLOT:
+      draw_plot(view, node, w, h);
+      break;
+  }
+}
+
+// Nós alterados danificam a área antiga e a nova; cada área danificada é
+// limpa e redesenhada com os nós que a cruzam, de baixo para cima. As áreas
+// entram na lista de envio, que acumula enquanto não for enviada.
+size_t ssd1306_scene_render(ssd1306_scene_t *scene) {
+  for (size_t i = 0; i < scene->count; ++i) {
+    ssd1306_node_t *node = scene->nodes[i];
+    if (node->type == SSD1306_NODE_PLOT)
+      plot_sync(scene, node);
+    if (!node->dirty)
+      continue;
+    ssd1306_area_t box = node->visible ? node->box : empty_area;
+    if (!area_equal(&node->shown, &box)) {
+      if (!area_empty(&node->shown))
+        damage_add(scene->ssd, scene->pending, &scene->pending_count, node->shown);
+      node->shown = box;
+    }
+    if (!area_empty(&box))
+      damage_add(scene->ssd, scene->pending, &scene->pending_count, box);
+    node->dirty = false;
+  }
+
+  size_t drawn = scene->pending_count;
+  for (size_t d = 0; d < drawn; ++d) {
+    const ssd1306_area_t *r = &scene->pending[d];
+    ssd1306_view_t area;
+    ssd1306_view_init(&area, scene->ssd, r->x0, r->y0, r->x1 - r->x0 + 1, r->y1 - r->y0 + 1);
+    ssd1306_view_fill(&area, false);
+
+    for (size_t i = 0; i < scene->count; ++i) {
+      const ssd1306_node_t *node = scene->nodes[i];
+      if (!node->visible || area_empty(&node->box) || !area_overlap(&node->box, r))
+        continue;
+      ssd1306_view_t view;
+      ssd1306_view_sub(&view, &area, node->box.x0 - r->x0, node->box.y0 - r->y0, node->box.x1 - node->box.x0 + 1,
+                       node->box.y1 - node->box.y0 + 1);
+      draw_node(&view, node);
+      scene->stats.nodes_drawn++;
+    }
+    scene->stats.damage_bytes += area_bytes(r);
+    damage_add(scene->ssd, scene->damage, &scene->damage_count, *r);
+  }
+  scene->pending_count = 0;
+  scene->stats.renders++;
+  scene->stats.damage_rects += drawn;
+  return drawn;
+}
+
+void ssd1306_scene_send(ssd1306_scene_t *scene) {
+  ssd1306_send_areas(scene->ssd, scene->damage, scene->damage_count);
+  scene->damage_count = 0;
+}
+
+// false com o barramento ocupado; a lista fica para o próximo envio
+bool ssd1306_scene_send_async(ssd1306_scene_t *scene) {
+  if (!ssd1306_send_areas_async(scene->ssd, scene->damage, scene->damage_count))
+    return false;
+  scene->damage_count = 0;
+  return true;
+}
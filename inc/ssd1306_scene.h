@@ -0,0 +1,123 @@
+#ifndef SSD1306_SCENE_H
+#define SSD1306_SCENE_H
+
+#include "ssd1306.h"
+#include "ssd1306_blit.h"
+#include "strip_chart.h"
+
+// Cena retida: a tela é descrita por nós (borda, rótulo, sprite, barra e
+// gráfico) que guardam o próprio retângulo e só invalidam o que mudou. A cada
+// ssd1306_scene_render as áreas danificadas são limpas e redesenhadas com os
+// nós que as cruzam, na ordem em que foram adicionados e recortados pela área,
+// e viram a lista de danos enviada com ssd1306_send_areas.
+// Os nós pertencem ao chamador; o framebuffer deve ser desenhado só pela cena.
+
+#define SSD1306_SCENE_MAX_NODES 16
+// Uma área de dano por janela de envio
+#define SSD1306_SCENE_MAX_DAMAGE SSD1306_MAX_WINDOWS
+#define SSD1306_LABEL_MAX 16
+
+typedef enum {
+  SSD1306_NODE_BORDER,
+  SSD1306_NODE_LABEL,
+  SSD1306_NODE_SPRITE,
+  SSD1306_NODE_BAR,
+  SSD1306_NODE_PLOT,
+} ssd1306_node_type_t;
+
+// Mesmos estilos de draw_border no firmware
+typedef enum {
+  SSD1306_BORDER_SOLID,
+  SSD1306_BORDER_DOTTED,
+  SSD1306_BORDER_DOUBLE,
+} ssd1306_border_style_t;
+
+typedef struct {
+  ssd1306_node_type_t type;
+  ssd1306_area_t box;     // posição atual na tela
+  ssd1306_area_t shown;   // área desenhada no último render (vazia se oculto)
+  bool visible;
+  bool dirty;             // redesenhar o nó inteiro (movido, mostrado, trocado)
+  union {
+    struct {
+      ssd1306_border_style_t style;
+    } border;
+    struct {
+      char text[SSD1306_LABEL_MAX + 1];
+    } label;
+    struct {
+      const ssd1306_bitmap_t *bitmap;
+      const ssd1306_bitmap_t *mask;
+      ssd1306_blit_mode_t mode;
+    } sprite;
+    // Contorno com preenchimento proporcional a value / max, da esquerda
+    // para a direita ou de baixo para cima
+    struct {
+      uint16_t value, max;
+      uint8_t length;     // pixels preenchidos
+      bool vertical;
+    } bar;
+    // Eixos à esquerda e embaixo; a área interna é um strip_chart_t, que
+    // guarda o histórico (com o envelope mín./máx.) e desenha as colunas
+    struct {
+      strip_chart_t *chart;   // do chamador
+      uint32_t head;          // colunas já danificadas
+    } plot;
+  };
+} ssd1306_node_t;
+
+typedef struct {
+  uint32_t renders;
+  uint32_t nodes_drawn;   // nós rasterizados, somando cada área
+  uint32_t damage_rects;
+  uint32_t damage_bytes;  // bytes de framebuffer cobertos pelas áreas
+} ssd1306_scene_stats_t;
+
+typedef struct {
+  ssd1306_t *ssd;
+  ssd1306_node_t *nodes[SSD1306_SCENE_MAX_NODES];  // de baixo para cima
+  size_t count;
+  ssd1306_area_t pending[SSD1306_SCENE_MAX_DAMAGE];  // danos desde o último render
+  size_t pending_count;
+  ssd1306_area_t damage[SSD1306_SCENE_MAX_DAMAGE];   // redesenhadas no último render
+  size_t damage_count;
+  ssd1306_scene_stats_t stats;
+} ssd1306_scene_t;
+
+// A primeira renderização limpa e desenha a tela inteira
+void ssd1306_scene_init(ssd1306_scene_t *scene, ssd1306_t *ssd);
+bool ssd1306_scene_add(ssd1306_scene_t *scene, ssd1306_node_t *node);
+
+// Inicializa o nó (visível); adicionar à cena com ssd1306_scene_add
+void ssd1306_node_border(ssd1306_node_t *node, int x, int y, int w, int h, ssd1306_border_style_t style);
+void ssd1306_node_label(ssd1306_node_t *node, int x, int y, const char *text);
+void ssd1306_node_sprite(ssd1306_node_t *node, int x, int y, const ssd1306_bitmap_t *bitmap,
+                         const ssd1306_bitmap_t *mask, ssd1306_blit_mode_t mode);
+void ssd1306_node_bar(ssd1306_node_t *node, int x, int y, int w, int h, uint16_t max, bool vertical);
+// O nó mede largura + 1 por altura + 1 do gráfico, com os eixos
+void ssd1306_node_plot(ssd1306_node_t *node, int x, int y, strip_chart_t *chart);
+
+void ssd1306_node_move(ssd1306_node_t *node, int x, int y);
+void ssd1306_node_show(ssd1306_node_t *node, bool visible);
+void ssd1306_node_set_border(ssd1306_node_t *node, ssd1306_border_style_t style);
+void ssd1306_node_set_bitmap(ssd1306_node_t *node, const ssd1306_bitmap_t *bitmap, const ssd1306_bitmap_t *mask);
+
+// Atualizações parciais: danificam só os pixels que mudam (caracteres
+// diferentes, trecho da barra, colunas do gráfico). Amostras acrescentadas
+// direto com strip_chart_push são danificadas no render seguinte
+void ssd1306_scene_set_label(ssd1306_scene_t *scene, ssd1306_node_t *node, const char *text);
+void ssd1306_scene_set_bar(ssd1306_scene_t *scene, ssd1306_node_t *node, uint16_t value);
+void ssd1306_scene_plot_push(ssd1306_scene_t *scene, ssd1306_node_t *node, uint16_t sample);
+
+// Danifica uma área da tela (ex.: para redesenhar tudo)
+void ssd1306_scene_damage(ssd1306_scene_t *scene, int x0, int y0, int x1, int y1);
+
+// Redesenha as áreas danificadas e as publica em scene->damage; retorna
+// quantas são (0: nada mudou)
+size_t ssd1306_scene_render(ssd1306_scene_t *scene);
+
+// Envia a lista de danos do último render
+void ssd1306_scene_send(ssd1306_scene_t *scene);
+bool ssd1306_scene_send_async(ssd1306_scene_t *scene);
+
+#endif // SSD1306_SCENE_H
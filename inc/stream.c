@@ -0,0 +1,104 @@
+#include "stream.h"
+#include <string.h>
+
+static void put_u16(uint8_t *p, uint16_t v) {
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void put_u32(uint8_t *p, uint32_t v) {
+  put_u16(p, v);
+  put_u16(p + 2, v >> 16);
+}
+
+uint16_t stream_crc16(const uint8_t *data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  while (len--) {
+    crc ^= (uint16_t)*data++ << 8;
+    for (int i = 0; i < 8; ++i)
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+  }
+  return crc;
+}
+
+void stream_init(stream_t *s, uint32_t sample_rate_hz) {
+  memset(s, 0, sizeof(*s));
+  s->period_us = sample_rate_hz ? 1000000u / sample_rate_hz : 0;
+}
+
+void stream_start(stream_t *s) {
+  s->count = 0;
+  s->lost = 0;
+  s->active = true;
+}
+
+void stream_stop(stream_t *s) {
+  s->active = false;
+  s->count = 0;
+  s->head = s->tail = 0;
+  s->offset = 0;
+}
+
+void stream_note_lost(stream_t *s, uint32_t samples) {
+  if (s->active)
+    s->lost += samples;
+}
+
+// Fecha o quadro em montagem: CRC e cópia para a fila (ou descarte)
+static void stream_finish(stream_t *s) {
+  uint8_t *f = s->building;
+  put_u16(&f[STREAM_FRAME_BYTES - 2], stream_crc16(f, STREAM_FRAME_BYTES - 2));
+  s->seq++;
+  s->count = 0;
+
+  if (s->head - s->tail == STREAM_QUEUE_FRAMES) {
+    s->dropped++;
+    return;
+  }
+  memcpy(s->queue[s->head % STREAM_QUEUE_FRAMES], f, STREAM_FRAME_BYTES);
+  s->head++;
+}
+
+void stream_push(stream_t *s, uint16_t x, uint16_t y, uint32_t timestamp_us) {
+  if (!s->active)
+    return;
+
+  uint8_t *f = s->building;
+  if (s->count == 0) {
+    f[0] = 0xA5;
+    f[1] = 0x5A;
+    f[2] = STREAM_VERSION;
+    f[3] = STREAM_SAMPLES;
+    put_u32(&f[4], s->seq);
+    put_u32(&f[8], timestamp_us);
+    put_u16(&f[12], s->period_us);
+    put_u16(&f[14], s->lost > 0xFFFF ? 0xFFFF : s->lost);
+    s->lost = 0;
+  }
+
+  uint8_t *p = &f[STREAM_HEADER_BYTES + s->count * 3];
+  p[0] = x;
+  p[1] = ((x >> 8) & 0x0F) | (y << 4);
+  p[2] = y >> 4;
+
+  if (++s->count == STREAM_SAMPLES)
+    stream_finish(s);
+}
+
+size_t stream_take(stream_t *s, uint8_t *dst, size_t max) {
+  size_t len = 0;
+  while (len < max && s->tail != s->head) {
+    const uint8_t *f = s->queue[s->tail % STREAM_QUEUE_FRAMES];
+    size_t n = STREAM_FRAME_BYTES - s->offset;
+    if (n > max - len)
+      n = max - len;
+    memcpy(&dst[len], &f[s->offset], n);
+    len += n;
+    s->offset += n;
+    if (s->offset == STREAM_FRAME_BYTES) {
+      s->offset = 0;
+      s->tail++;
+    }
+  }
+  return len;
+}
@@ -0,0 +1,48 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Streaming binário das amostras X/Y. Cada quadro tem tamanho fixo
+// (little-endian):
+//   0  magic 0xA5 0x5A      2  versão        3  amostras no quadro
+//   4  sequência (u32)      8  instante da 1ª amostra em µs (u32)
+//   12 período entre amostras em µs (u16)
+//   14 amostras perdidas pelo ADC antes deste quadro (u16, satura)
+//   16 amostras: 3 bytes cada, x[7:0], x[11:8] | y[3:0] << 4, y[11:4]
+//   .. CRC-16/CCITT-FALSE de todos os bytes anteriores (u16)
+// A sequência avança também para quadros descartados por falta de espaço na
+// fila, então o leitor detecta as perdas pelos saltos. Não depende do SDK.
+#define STREAM_VERSION 1
+#define STREAM_SAMPLES 32
+#define STREAM_HEADER_BYTES 16
+#define STREAM_FRAME_BYTES (STREAM_HEADER_BYTES + STREAM_SAMPLES * 3 + 2)
+#define STREAM_QUEUE_FRAMES 16  // quadros prontos aguardando envio (potência de 2)
+
+typedef struct {
+  uint8_t queue[STREAM_QUEUE_FRAMES][STREAM_FRAME_BYTES];
+  uint32_t head, tail;      // quadros prontos: [tail, head)
+  size_t offset;            // bytes do quadro em tail já entregues
+  uint8_t building[STREAM_FRAME_BYTES];
+  uint8_t count;            // amostras no quadro em montagem
+  uint32_t seq;
+  uint16_t period_us;
+  uint32_t lost;            // perdas do ADC ainda não informadas
+  uint32_t dropped;         // quadros descartados com a fila cheia
+  bool active;
+} stream_t;
+
+void stream_init(stream_t *s, uint32_t sample_rate_hz);
+void stream_start(stream_t *s);
+// Descarta o quadro em montagem e os que não foram entregues
+void stream_stop(stream_t *s);
+void stream_push(stream_t *s, uint16_t x, uint16_t y, uint32_t timestamp_us);
+void stream_note_lost(stream_t *s, uint32_t samples);
+// Copia para dst até max bytes dos quadros prontos (o último pode ficar pela
+// metade e continua na próxima chamada); retorna quantos bytes foram copiados
+size_t stream_take(stream_t *s, uint8_t *dst, size_t max);
+uint16_t stream_crc16(const uint8_t *data, size_t len);
+
+#endif // STREAM_H
@@ -0,0 +1,118 @@
+#include "strip_chart.h"
+
+void strip_chart_init(strip_chart_t *chart, uint8_t width, uint8_t height, uint16_t range_lo, uint16_t range_hi,
+                      uint16_t per_column) {
+  chart->width = width < STRIP_CHART_MAX_WIDTH ? width : STRIP_CHART_MAX_WIDTH;
+  chart->height = height;
+  chart->range_lo = range_lo;
+  chart->range_hi = range_hi > range_lo ? range_hi : range_lo + 1;
+  chart->per_column = per_column ? per_column : 1;
+  chart->count = 0;
+  atomic_init(&chart->head, 0);
+  chart->drawn = 0;
+}
+
+bool strip_chart_push(strip_chart_t *chart, uint16_t sample) {
+  if (chart->count == 0 || sample < chart->lo)
+    chart->lo = sample;
+  if (chart->count == 0 || sample > chart->hi)
+    chart->hi = sample;
+  if (++chart->count < chart->per_column)
+    return false;
+
+  uint32_t head = atomic_load_explicit(&chart->head, memory_order_relaxed);
+  chart->columns[head % chart->width] = (strip_chart_column_t){ chart->lo, chart->hi };
+  atomic_store_explicit(&chart->head, head + 1, memory_order_release);
+  chart->count = 0;
+  return true;
+}
+
+uint32_t strip_chart_head(strip_chart_t *chart) {
+  return atomic_load_explicit(&chart->head, memory_order_acquire);
+}
+
+static int strip_chart_row(const strip_chart_t *chart, uint16_t v) {
+  if (v < chart->range_lo) v = chart->range_lo;
+  if (v > chart->range_hi) v = chart->range_hi;
+  return (chart->height - 1) - (int32_t)(v - chart->range_lo) * (chart->height - 1) / (chart->range_hi - chart->range_lo);
+}
+
+// Envelope da coluna na posição x; ligada à anterior (prev), estende-se até
+// tocar o envelope dela para o traço não ficar com buracos nas subidas rápidas
+static void strip_chart_envelope(strip_chart_t *chart, ssd1306_view_t *view, uint8_t x, strip_chart_column_t col,
+                                 const strip_chart_column_t *prev) {
+  int top = strip_chart_row(chart, col.hi);
+  int bottom = strip_chart_row(chart, col.lo);
+
+  if (prev) {
+    int prev_top = strip_chart_row(chart, prev->hi);
+    int prev_bottom = strip_chart_row(chart, prev->lo);
+    if (prev_top > bottom) bottom = prev_top;
+    if (prev_bottom < top) top = prev_bottom;
+  }
+  ssd1306_view_vline(view, x, 0, chart->height - 1, false);
+  ssd1306_view_vline(view, x, top, bottom, true);
+}
+
+// Coluna index do histórico, lida no anel; só para colunas abaixo de head
+static void strip_chart_column(strip_chart_t *chart, ssd1306_view_t *view, uint32_t index, bool connect) {
+  uint8_t x = index % chart->width;
+  strip_chart_envelope(chart, view, x, chart->columns[x], connect && x > 0 ? &chart->columns[x - 1] : NULL);
+}
+
+// Colunas de x0 a x1 da janela com o histórico até head; as posições sem
+// coluna no histórico (a marca de varredura, o anel ainda incompleto) ficam
+// apagadas
+static void strip_chart_columns(strip_chart_t *chart, ssd1306_view_t *view, uint32_t head, int x0, int x1) {
+  // A posição seguinte à mais nova fica vazia: cabem largura - 1 colunas
+  uint32_t first = head >= chart->width ? head - chart->width + 1 : 0;
+  if (x0 < 0) x0 = 0;
+  if (x1 > chart->width - 1) x1 = chart->width - 1;
+
+  for (int x = x0; x <= x1; ++x) {
+    // Coluna mais recente nesta posição do anel
+    uint32_t back = head ? ((head - 1) % chart->width + chart->width - x) % chart->width : 0;
+    if (head == 0 || back > head - 1 - first) {
+      ssd1306_view_vline(view, x, 0, chart->height - 1, false);
+      continue;
+    }
+    uint32_t i = head - 1 - back;
+    strip_chart_column(chart, view, i, i > first);
+  }
+}
+
+void strip_chart_draw_range(strip_chart_t *chart, ssd1306_view_t *view, int x0, int x1) {
+  strip_chart_columns(chart, view, strip_chart_head(chart), x0, x1);
+}
+
+void strip_chart_redraw(strip_chart_t *chart, ssd1306_view_t *view) {
+  uint32_t head = strip_chart_head(chart);
+  strip_chart_columns(chart, view, head, 0, chart->width - 1);
+  chart->drawn = head;
+}
+
+void strip_chart_draw(strip_chart_t *chart, ssd1306_view_t *view) {
+  uint32_t head = strip_chart_head(chart);
+  if (head == chart->drawn)
+    return;
+  if (head - chart->drawn >= chart->width) {
+    strip_chart_redraw(chart, view);
+    return;
+  }
+
+  for (uint32_t i = chart->drawn; i < head; ++i)
+    strip_chart_column(chart, view, i, true);
+  ssd1306_view_vline(view, head % chart->width, 0, chart->height - 1, false);
+  // A mais antiga se ligava à que acabou de ser apagada. A posição dela é a
+  // próxima que o produtor reescreve depois da que está em formação: a cópia
+  // só vale se head não andou durante a leitura. Se andou, a posição é
+  // apagada (marca de varredura) ou redesenhada no próximo desenho
+  if (head >= chart->width) {
+    uint8_t x = (head + 1) % chart->width;
+    strip_chart_column_t oldest = chart->columns[x];
+    atomic_thread_fence(memory_order_acquire);
+    if (atomic_load_explicit(&chart->head, memory_order_relaxed) == head)
+      strip_chart_envelope(chart, view, x, oldest, NULL);
+  }
+  chart->drawn = head;
+}
@@ -0,0 +1,63 @@
+#ifndef STRIP_CHART_H
+#define STRIP_CHART_H
+
+#include <stdatomic.h>
+#include "ssd1306.h"
+
+// Histórico em faixa, como um osciloscópio em varredura. As amostras chegam
+// na taxa do sinal e são decimadas em colunas: cada coluna guarda o mínimo e
+// o máximo do seu intervalo (o envelope), então picos entre duas colunas não
+// se perdem. As colunas ficam em um anel com uma posição por coluna da tela, e
+// o anel é o próprio endereçamento: a coluna n do sinal vai sempre para
+// x = n % largura. Cada coluna nova reescreve só a sua posição, apaga a
+// seguinte (a marca de varredura) e retira a ligação da mais antiga; o envio
+// diferencial leva ao display só essas colunas.
+//
+// O SSD1306 tem rolagem horizontal contínua (SET_HSCROLL_*), mas ela avança no
+// ritmo do oscilador do painel e o controlador não pode ter a GDDRAM escrita
+// enquanto rola, então não dá para acrescentar colunas sincronizadas com ela.
+//
+// Um produtor (strip_chart_push) e um consumidor (desenho) podem estar em
+// núcleos diferentes: head é publicado com release depois da coluna.
+
+#define STRIP_CHART_MAX_WIDTH SSD1306_MAX_WIDTH
+
+typedef struct {
+  uint16_t lo, hi;
+} strip_chart_column_t;
+
+typedef struct {
+  strip_chart_column_t columns[STRIP_CHART_MAX_WIDTH];
+  uint8_t width, height;
+  uint16_t range_lo, range_hi;   // faixa do eixo vertical
+  uint16_t per_column;           // amostras por coluna
+  // Produtor: coluna em formação
+  uint16_t count;
+  uint16_t lo, hi;
+  _Atomic uint32_t head;         // colunas fechadas desde o início
+  // Consumidor
+  uint32_t drawn;                // colunas já desenhadas
+} strip_chart_t;
+
+void strip_chart_init(strip_chart_t *chart, uint8_t width, uint8_t height, uint16_t range_lo, uint16_t range_hi,
+                      uint16_t per_column);
+
+// Acumula uma amostra; true quando ela fecha uma coluna
+bool strip_chart_push(strip_chart_t *chart, uint16_t sample);
+
+// Colunas fechadas até agora
+uint32_t strip_chart_head(strip_chart_t *chart);
+
+// Desenha as colunas fechadas desde a última chamada na janela (origem no
+// canto superior esquerdo do gráfico). Atrasado mais que uma volta do anel,
+// redesenha tudo
+void strip_chart_draw(strip_chart_t *chart, ssd1306_view_t *view);
+
+// Redesenha todo o histórico (ex.: depois de a tela ser apagada)
+void strip_chart_redraw(strip_chart_t *chart, ssd1306_view_t *view);
+
+// Redesenha só as colunas de x0 a x1, cada uma na altura inteira, sem mexer em
+// drawn; usado por quem decide o que redesenhar (o nó de gráfico da cena)
+void strip_chart_draw_range(strip_chart_t *chart, ssd1306_view_t *view, int x0, int x1);
+
+#endif // STRIP_CHART_H
@@ -0,0 +1,141 @@
+#include "trace.h"
+
+#if TRACE_ENABLED
+
+#include "hardware/sync.h"
+#include <string.h>
+
+typedef struct {
+  uint32_t start_us;
+  uint16_t duration_us;
+  uint8_t stage;
+  uint8_t core;
+} trace_event_t;
+
+typedef struct {
+  uint32_t count;
+  uint32_t min_us;
+  uint32_t max_us;
+  uint64_t sum_us;
+  uint32_t buckets[TRACE_BUCKETS];
+} trace_hist_t;
+
+// Cada núcleo escreve apenas no próprio anel; as IRQs do núcleo ficam
+// desligadas durante a escrita para que um evento não se intercale com outro
+static struct {
+  trace_event_t ring[TRACE_RING_SIZE];
+  uint32_t head;   // total de eventos já escritos
+  trace_hist_t hist[TRACE_STAGE_COUNT];
+} trace_core[TRACE_CORES];
+
+static uint32_t trace_checksum;
+
+void trace_init(void) {
+  memset(trace_core, 0, sizeof(trace_core));
+  for (uint c = 0; c < TRACE_CORES; ++c)
+    for (uint s = 0; s < TRACE_STAGE_COUNT; ++s)
+      trace_core[c].hist[s].min_us = UINT32_MAX;
+}
+
+static uint trace_bucket(uint32_t us) {
+  uint b = 0;
+  while (us && b < TRACE_BUCKETS - 1) {
+    us >>= 1;
+    ++b;
+  }
+  return b;
+}
+
+void trace_record(trace_stage_t stage, uint32_t start_us, uint32_t end_us) {
+  uint core = get_core_num();
+  uint32_t duration = end_us - start_us;
+  uint32_t irq = save_and_disable_interrupts();
+
+  trace_event_t *ev = &trace_core[core].ring[trace_core[core].head & (TRACE_RING_SIZE - 1)];
+  ev->start_us = start_us;
+  ev->duration_us = duration > UINT16_MAX ? UINT16_MAX : duration;
+  ev->stage = stage;
+  ev->core = core;
+  trace_core[core].head++;
+
+  trace_hist_t *h = &trace_core[core].hist[stage];
+  h->count++;
+  h->sum_us += duration;
+  if (duration < h->min_us)
+    h->min_us = duration;
+  if (duration > h->max_us)
+    h->max_us = duration;
+  h->buckets[trace_bucket(duration)]++;
+
+  restore_interrupts(irq);
+}
+
+static void put_bytes(const void *data, size_t len) {
+  const uint8_t *p = data;
+  for (size_t i = 0; i < len; ++i) {
+    trace_checksum += p[i];
+    putchar_raw(p[i]);
+  }
+}
+
+static void put_u8(uint8_t v) {
+  put_bytes(&v, 1);
+}
+
+static void put_u16(uint16_t v) {
+  uint8_t b[2] = { v, v >> 8 };
+  put_bytes(b, sizeof(b));
+}
+
+static void put_u32(uint32_t v) {
+  uint8_t b[4] = { v, v >> 8, v >> 16, v >> 24 };
+  put_bytes(b, sizeof(b));
+}
+
+static void put_u64(uint64_t v) {
+  put_u32(v);
+  put_u32(v >> 32);
+}
+
+// O outro núcleo continua registrando durante o dump: os eventos mais antigos
+// do seu anel podem ser sobrescritos, o que só descarta parte do histórico
+void trace_dump(void) {
+  trace_checksum = 0;
+  put_bytes("BDTR", 4);
+  put_u8(TRACE_DUMP_VERSION);
+  put_u8(TRACE_CORES);
+  put_u8(TRACE_STAGE_COUNT);
+  put_u8(TRACE_BUCKETS);
+  put_u16(TRACE_RING_SIZE);
+  put_u32(time_us_32());
+
+  for (uint c = 0; c < TRACE_CORES; ++c) {
+    for (uint s = 0; s < TRACE_STAGE_COUNT; ++s) {
+      trace_hist_t h = trace_core[c].hist[s];
+      put_u32(h.count);
+      put_u32(h.count ? h.min_us : 0);
+      put_u32(h.max_us);
+      put_u64(h.sum_us);
+      for (uint b = 0; b < TRACE_BUCKETS; ++b)
+        put_u32(h.buckets[b]);
+    }
+  }
+
+  for (uint c = 0; c < TRACE_CORES; ++c) {
+    uint32_t head = trace_core[c].head;
+    uint32_t n = head < TRACE_RING_SIZE ? head : TRACE_RING_SIZE;
+    put_u32(head);
+    for (uint32_t i = head - n; i != head; ++i) {
+      trace_event_t ev = trace_core[c].ring[i & (TRACE_RING_SIZE - 1)];
+      put_u32(ev.start_us);
+      put_u16(ev.duration_us);
+      put_u8(ev.stage);
+      put_u8(ev.core);
+    }
+  }
+
+  put_u32(trace_checksum);
+  stdio_flush();
+}
+
+#endif // TRACE_ENABLED
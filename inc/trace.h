@@ -0,0 +1,56 @@
+#ifndef TRACE_H
+#define TRACE_H
+
+#include "pico/stdlib.h"
+
+// Instrumentação dos estágios do laço principal: cada trecho medido vira um
+// evento em um anel por núcleo e alimenta min/max/média e um histograma log2.
+// Com TRACE_ENABLED=0 (padrão) as macros não geram código e trace.c fica vazio
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED 0
+#endif
+
+#define TRACE_RING_BITS 9
+#define TRACE_RING_SIZE (1u << TRACE_RING_BITS)   // eventos por núcleo
+#define TRACE_CORES 2
+#define TRACE_BUCKETS 16          // [0], [1], [2,3], [4,7], ... µs; o último acumula o resto
+#define TRACE_DUMP_VERSION 1
+
+// A ordem é parte do formato do dump (tools/trace_decode.py)
+typedef enum {
+  TRACE_STAGE_ADC,      // leitura do anel do ADC e filtragem
+  TRACE_STAGE_PWM,      // atualização dos LEDs
+  TRACE_STAGE_RASTER,   // desenho do quadro no framebuffer
+  TRACE_STAGE_FLUSH,    // diff e montagem das janelas para o I2C
+  TRACE_STAGE_I2C_BUS,  // transferência por DMA até a IRQ de término
+  TRACE_STAGE_SLEEP,    // espera até o próximo período
+  TRACE_STAGE_COUNT
+} trace_stage_t;
+
+#if TRACE_ENABLED
+
+void trace_init(void);
+
+// Seguro em IRQ e nos dois núcleos; durações acima de 65535 µs saturam
+void trace_record(trace_stage_t stage, uint32_t start_us, uint32_t end_us);
+
+// Escreve o dump binário em stdio (sem tradução de fim de linha):
+//   "BDTR" versão núcleos estágios buckets anel(u16) agora_us(u32)
+//   por núcleo e estágio: count min max (u32) soma (u64) buckets (u32 x N)
+//   por núcleo: total de eventos (u32) e os mais recentes, do mais antigo ao
+//   mais novo: início_us(u32) duração_us(u16) estágio(u8) núcleo(u8)
+//   soma de todos os bytes anteriores (u32)
+// Valores em little-endian
+void trace_dump(void);
+
+#define TRACE_BEGIN(var) uint32_t var = time_us_32()
+#define TRACE_END(stage, var) trace_record((stage), (var), time_us_32())
+
+#else
+
+#define TRACE_BEGIN(var) do { } while (0)
+#define TRACE_END(stage, var) do { } while (0)
+
+#endif // TRACE_ENABLED
+
+#endif // TRACE_H
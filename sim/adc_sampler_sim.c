@@ -0,0 +1,81 @@
+#include "adc_sampler.h"
+#include "sim.h"
+
+// Amostrador do host: gera os quadros X/Y que o DMA teria escrito no anel
+// desde a última leitura, consultando o roteiro no instante de cada quadro.
+// Mantém a mesma capacidade do anel e a mesma contagem de perdas.
+#define ADC_SAMPLER_RING_FRAMES (ADC_SAMPLER_RING_SAMPLES / 2)
+
+static uint32_t frame_rate;
+static bool running;
+static uint64_t next_frame;     // índice do próximo quadro a entregar
+static uint64_t start_us;
+static uint32_t overruns;
+
+static uint64_t frame_time_us(uint64_t index) {
+  return start_us + index * 1000000u / frame_rate;
+}
+
+void adc_sampler_init(uint32_t frame_rate_hz) {
+  if (frame_rate_hz == 0)
+    frame_rate_hz = 1;
+  if (frame_rate_hz > ADC_SAMPLER_MAX_FRAME_RATE)
+    frame_rate_hz = ADC_SAMPLER_MAX_FRAME_RATE;
+  frame_rate = frame_rate_hz;
+  running = false;
+  overruns = 0;
+}
+
+void adc_sampler_start(void) {
+  start_us = sim_now_us();
+  next_frame = 0;
+  running = true;
+}
+
+void adc_sampler_stop(void) {
+  running = false;
+}
+
+// Quadros completos até o instante atual
+static uint64_t frames_done(void) {
+  return (sim_now_us() - start_us) * frame_rate / 1000000u;
+}
+
+size_t adc_sampler_read(adc_frame_t *out, size_t max) {
+  if (!running)
+    return 0;
+
+  uint64_t done = frames_done();
+  if (done - next_frame > ADC_SAMPLER_RING_FRAMES) {
+    overruns += done - next_frame - ADC_SAMPLER_RING_FRAMES;
+    next_frame = done - ADC_SAMPLER_RING_FRAMES;
+  }
+
+  size_t n = 0;
+  for (; n < max && next_frame < done; ++n, ++next_frame) {
+    uint64_t t = frame_time_us(next_frame);
+    out[n].x = sim_adc_value(0, t);
+    out[n].y = sim_adc_value(1, t);
+    out[n].timestamp_us = t;
+  }
+  return n;
+}
+
+bool adc_sampler_latest(adc_frame_t *out) {
+  uint64_t done = running ? frames_done() : 0;
+  if (done == 0)
+    return false;
+  uint64_t t = frame_time_us(done - 1);
+  out->x = sim_adc_value(0, t);
+  out->y = sim_adc_value(1, t);
+  out->timestamp_us = t;
+  return true;
+}
+
+uint32_t adc_sampler_frame_rate(void) {
+  return frame_rate;
+}
+
+uint32_t adc_sampler_overruns(void) {
+  return overruns;
+}
@@ -0,0 +1,19 @@
+#ifndef SIM_HARDWARE_FLASH_H
+#define SIM_HARDWARE_FLASH_H
+
+#include "pico/stdlib.h"
+
+// Flash emulada em RAM, com a semântica do hardware: apagar leva a 0xFF e
+// programar só limpa bits. Basta o tamanho para o setor reservado do firmware;
+// --flash carrega e salva a imagem entre execuções
+#define PICO_FLASH_SIZE_BYTES (64u * 1024u)
+#define FLASH_SECTOR_SIZE 4096u
+#define FLASH_PAGE_SIZE 256u
+
+extern uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)sim_flash)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#endif // SIM_HARDWARE_FLASH_H
@@ -0,0 +1,17 @@
+#ifndef SIM_HARDWARE_PWM_H
+#define SIM_HARDWARE_PWM_H
+
+#include "pico/stdlib.h"
+
+#define PWM_CHAN_A 0
+#define PWM_CHAN_B 1
+
+static inline uint pwm_gpio_to_slice_num(uint gpio) { return (gpio >> 1u) & 7u; }
+static inline uint pwm_gpio_to_channel(uint gpio) { return gpio & 1u; }
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap);
+void pwm_set_enabled(uint slice_num, bool enabled);
+void pwm_set_clkdiv(uint slice_num, float divider);
+void pwm_set_gpio_level(uint gpio, uint16_t level);
+
+#endif // SIM_HARDWARE_PWM_H
@@ -0,0 +1,17 @@
+#ifndef SIM_PICO_FLASH_H
+#define SIM_PICO_FLASH_H
+
+#include "pico/stdlib.h"
+
+#define PICO_OK 0
+
+// Sem o outro núcleo nem XIP a pausar, a função roda na hora
+static inline int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+  (void)enter_exit_timeout_ms;
+  func(param);
+  return PICO_OK;
+}
+
+static inline bool flash_safe_execute_core_init(void) { return true; }
+
+#endif // SIM_PICO_FLASH_H
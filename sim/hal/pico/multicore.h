@@ -0,0 +1,12 @@
+#ifndef SIM_PICO_MULTICORE_H
+#define SIM_PICO_MULTICORE_H
+
+#include "pico/stdlib.h"
+
+// A simulação roda em uma só thread (DUAL_CORE=0); o núcleo 1 não existe
+void multicore_launch_core1(void (*entry)(void));
+
+static inline void __sev(void) {}
+static inline void __wfe(void) {}
+
+#endif // SIM_PICO_MULTICORE_H
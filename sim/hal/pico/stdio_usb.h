@@ -0,0 +1,17 @@
+#ifndef SIM_PICO_STDIO_USB_H
+#define SIM_PICO_STDIO_USB_H
+
+#include "pico/stdlib.h"
+
+// Só a parte do driver usada pelo firmware: a saída vai para o stdout do
+// processo, junto com o texto de printf
+typedef struct stdio_driver {
+  void (*out_chars)(const char *buf, int len);
+  void (*out_flush)(void);
+} stdio_driver_t;
+
+extern stdio_driver_t stdio_usb;
+
+bool stdio_usb_connected(void);
+
+#endif // SIM_PICO_STDIO_USB_H
@@ -0,0 +1,11 @@
+#ifndef SIM_TUSB_H
+#define SIM_TUSB_H
+
+#include <stdint.h>
+
+// Espaço livre no FIFO de transmissão CDC (tamanho padrão do stdio_usb)
+#define SIM_CDC_TX_BUFSIZE 256
+
+uint32_t tud_cdc_write_available(void);
+
+#endif // SIM_TUSB_H
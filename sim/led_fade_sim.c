@@ -0,0 +1,54 @@
+#include "led_fade.h"
+#include "hardware/pwm.h"
+#include "sim.h"
+
+// Transporte do host: um alarme por slice faz o papel do DMA, disparando nos
+// wraps do PWM (múltiplos do período desde o boot, pois o contador não para)
+// e aplicando uma entrada da tabela por wrap. Os níveis aparecem no registro
+// da simulação com o tempo virtual de cada passo.
+#define LED_FADE_PERIOD_US (1000000u / LED_FADE_STEP_HZ)
+#define SIM_PWM_SLICES 8
+
+static struct {
+  const uint32_t *table;
+  size_t count;
+  size_t next;        // próxima entrada a aplicar
+  bool armed;         // alarme de wrap pendente
+} slices[SIM_PWM_SLICES];
+
+static void apply(uint slice, uint32_t cc) {
+  pwm_set_gpio_level(slice * 2, cc & 0xFFFF);
+  pwm_set_gpio_level(slice * 2 + 1, cc >> 16);
+}
+
+static int64_t sim_wrap(alarm_id_t id, void *arg) {
+  (void)id;
+  uint slice = (uint)(uintptr_t)arg;
+  if (slices[slice].next >= slices[slice].count) {
+    slices[slice].armed = false;
+    return 0;
+  }
+  apply(slice, slices[slice].table[slices[slice].next++]);
+  return LED_FADE_PERIOD_US;
+}
+
+void led_fade_hw_init(uint slice) {
+  (void)slice;
+}
+
+void led_fade_hw_start(uint slice, const uint32_t *table, size_t count) {
+  slices[slice].table = table;
+  slices[slice].count = count;
+  slices[slice].next = 0;
+  if (!slices[slice].armed && count > 0) {
+    uint64_t wrap = (sim_now_us() / LED_FADE_PERIOD_US + 1) * LED_FADE_PERIOD_US;
+    slices[slice].armed = add_alarm_at(from_us_since_boot(wrap), sim_wrap, (void *)(uintptr_t)slice, false) > 0;
+  }
+}
+
+size_t led_fade_hw_stop(uint slice) {
+  size_t done = slices[slice].next;
+  slices[slice].count = 0;
+  slices[slice].next = 0;
+  return done;
+}
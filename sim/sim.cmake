@@ -0,0 +1,30 @@
+# Simulação no host (-DBITDOGLAB_HOST_SIM=ON): a lógica do firmware compilada
+# sobre a HAL de sim/hal, com o display emulado e o ADC lido de um roteiro.
+# Exemplo: ./bitdoglab-sim --trace sim/traces/sweep.txt --frames quadros --out final.pbm
+set(SIM_SOURCES
+        embarcatech-adc-bitdoglab.c inc/ssd1306.c inc/ssd1306_blit.c inc/ssd1306_layer.c inc/ssd1306_scene.c inc/strip_chart.c inc/joystick_filter.c inc/spsc_queue.c inc/trace.c inc/scheduler.c inc/button.c inc/stream.c inc/led_fade.c inc/joystick_cal.c
+        sim/sim_hal.c sim/ssd1306_emu.c sim/ssd1306_i2c_sim.c sim/adc_sampler_sim.c sim/led_fade_sim.c
+        ${GENERATED_DIR}/font_ascii.h ${GENERATED_DIR}/joystick_lut.h)
+
+# O main() do firmware vira firmware_main(); nesta configuração não existe o
+# alvo do firmware, então a propriedade de fonte não o afeta
+set_source_files_properties(embarcatech-adc-bitdoglab.c PROPERTIES COMPILE_DEFINITIONS main=firmware_main)
+
+# sim/hal vem primeiro para substituir os cabeçalhos do SDK
+set(SIM_INCLUDE_DIRS
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim
+        ${CMAKE_CURRENT_SOURCE_DIR}
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc
+        ${GENERATED_DIR})
+
+add_executable(bitdoglab-sim ${SIM_SOURCES} sim/sim_main.c)
+target_compile_definitions(bitdoglab-sim PRIVATE DUAL_CORE=0 ${APP_DEFINITIONS})
+target_include_directories(bitdoglab-sim PRIVATE ${SIM_INCLUDE_DIRS})
+
+# Benchmarks das primitivas e do quadro completo, saída em JSON (uma linha por
+# caso). Compile com -DCMAKE_BUILD_TYPE=Release para números representativos
+add_executable(bitdoglab-bench ${SIM_SOURCES} bench/bench.c bench/ssd1306_bench.c)
+target_compile_definitions(bitdoglab-bench PRIVATE
+        DUAL_CORE=0 ${APP_DEFINITIONS} BENCH_REVISION="${BENCH_REVISION}")
+target_include_directories(bitdoglab-bench PRIVATE ${SIM_INCLUDE_DIRS} ${CMAKE_CURRENT_SOURCE_DIR}/bench)
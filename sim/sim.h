@@ -0,0 +1,51 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+
+// Controle da simulação no host. O relógio virtual avança apenas nos sleep_*
+// e __wfi do firmware (este até o próximo alarme) e no tempo de barramento das
+// transações I2C; cada espera marca o fim de um quadro, que é gravado em PBM
+// se a GDDRAM mudou desde o último.
+//
+// Roteiro de ADC (texto, uma entrada por linha, tempos crescentes em ms):
+//   <t> <x> <y>         leitura dos eixos a partir de t (degrau)
+//   <t> ramp <x> <y>    rampa linear da entrada anterior até (x, y) em t
+//   <t> press <gpio>    borda de descida no pino (botão pressionado)
+//   <t> release <gpio>  borda de subida (botão solto); sem ela, o botão
+//                       volta sozinho após 80 ms
+//   <t> end             fim da simulação
+// '#' inicia um comentário. Sem "end", a simulação termina 500 ms após a
+// última entrada.
+
+typedef struct {
+  const char *trace_path;   // roteiro de ADC; NULL mantém o joystick no centro
+  const char *frames_dir;   // diretório para frame_NNNNN.pbm; NULL desativa
+  const char *final_pbm;    // imagem final do painel; NULL desativa
+  FILE *log;                // registro de I2C/PWM/GPIO; NULL desativa
+  const char *flash_path;   // imagem da flash, lida no início e salva no fim; NULL começa apagada
+  uint64_t duration_us;     // 0 usa o fim do roteiro
+} sim_config_t;
+
+bool sim_init(const sim_config_t *config);
+
+uint64_t sim_now_us(void);
+
+// Avança o relógio disparando os eventos do roteiro no caminho. O fim do
+// roteiro é verificado nos sleep_*, que encerram com sim_finish
+void sim_advance_us(uint64_t us);
+
+// Entrega uma transação ao emulador e ao registro sem avançar o relógio;
+// devolve o tempo de barramento em µs (base de i2c_write_blocking e do
+// transporte assíncrono simulado)
+uint64_t sim_i2c_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len);
+
+// Leitura da entrada do ADC (0 = X, 1 = Y) no instante t_us do roteiro
+uint16_t sim_adc_value(uint input, uint64_t t_us);
+
+// Grava a imagem final e a da flash, imprime o resumo do tráfego e encerra o processo
+void sim_finish(void) __attribute__((noreturn));
+
+#endif // SIM_H
@@ -0,0 +1,554 @@
+#include "sim.h"
+#include "ssd1306_emu.h"
+#include "hardware/adc.h"
+#include "hardware/flash.h"
+#include "hardware/i2c.h"
+#include "hardware/pwm.h"
+#include "pico/stdio_usb.h"
+#include "tusb.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_GPIO_COUNT 30
+#define SIM_PRESS_US 80000      // duração de um press sem release correspondente
+#define SIM_TAIL_US 500000      // duração após a última entrada sem "end"
+#define SIM_ALARMS 8
+#define SIM_IDLE_US 1000        // avanço de um __wfi sem alarme pendente
+
+typedef enum { EV_STEP, EV_RAMP, EV_PRESS, EV_RELEASE, EV_END } sim_event_kind_t;
+
+typedef struct {
+  uint64_t t_us;
+  sim_event_kind_t kind;
+  uint16_t x, y;   // EV_STEP/EV_RAMP
+  uint gpio;       // EV_PRESS/EV_RELEASE
+} sim_event_t;
+
+// Instâncias referenciadas pelas macros i2c0/i2c1
+i2c_inst_t i2c0_inst = { 0, 0 };
+i2c_inst_t i2c1_inst = { 1, 0 };
+
+static sim_config_t cfg;
+static uint64_t now_us;
+static uint64_t end_us;
+
+static sim_event_t *events;
+static size_t event_count;
+static size_t event_capacity;
+static size_t next_button;    // próximo evento de botão ainda não disparado
+
+static gpio_irq_callback_t irq_callback;
+static uint32_t irq_events[SIM_GPIO_COUNT];
+static uint64_t pressed_until[SIM_GPIO_COUNT];
+static bool gpio_dir_out[SIM_GPIO_COUNT];
+static bool gpio_out[SIM_GPIO_COUNT];
+static uint16_t pwm_level[SIM_GPIO_COUNT];
+static uint adc_input;
+
+static struct {
+  uint64_t time_us;
+  alarm_callback_t callback;
+  void *user_data;
+  alarm_id_t id;   // 0 = livre
+} alarms[SIM_ALARMS];
+static alarm_id_t next_alarm_id = 1;
+
+static struct {
+  uint32_t transactions;
+  uint64_t bytes;
+  uint64_t busy_us;
+  uint32_t frames;
+  uint32_t dumped_generation;
+} traffic;
+
+static bool parse_trace(const char *path) {
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    perror(path);
+    return false;
+  }
+
+  char line[128];
+  unsigned lineno = 0;
+  while (fgets(line, sizeof(line), f)) {
+    ++lineno;
+    char *hash = strchr(line, '#');
+    if (hash)
+      *hash = '\0';
+
+    double t_ms;
+    unsigned a, b;
+    char word[8];
+    sim_event_t ev = {0};
+    if (sscanf(line, " %lf ramp %u %u", &t_ms, &a, &b) == 3) {
+      ev.kind = EV_RAMP;
+      ev.x = a;
+      ev.y = b;
+    } else if (sscanf(line, " %lf press %u", &t_ms, &a) == 2 && a < SIM_GPIO_COUNT) {
+      ev.kind = EV_PRESS;
+      ev.gpio = a;
+    } else if (sscanf(line, " %lf release %u", &t_ms, &a) == 2 && a < SIM_GPIO_COUNT) {
+      ev.kind = EV_RELEASE;
+      ev.gpio = a;
+    } else if (sscanf(line, " %lf %7s", &t_ms, word) == 2 && strcmp(word, "end") == 0) {
+      ev.kind = EV_END;
+    } else if (sscanf(line, " %lf %u %u", &t_ms, &a, &b) == 3) {
+      ev.kind = EV_STEP;
+      ev.x = a;
+      ev.y = b;
+    } else if (sscanf(line, " %7s", word) != 1) {
+      continue;  // linha vazia ou só comentário
+    } else {
+      fprintf(stderr, "%s:%u: entrada inválida\n", path, lineno);
+      fclose(f);
+      return false;
+    }
+
+    ev.t_us = (uint64_t)(t_ms * 1000.0);
+    if (ev.x > 4095 || ev.y > 4095 || (event_count && ev.t_us < events[event_count - 1].t_us)) {
+      fprintf(stderr, "%s:%u: valor fora de 0..4095 ou tempo decrescente\n", path, lineno);
+      fclose(f);
+      return false;
+    }
+
+    if (event_count == event_capacity) {
+      event_capacity *= 2;
+      events = realloc(events, event_capacity * sizeof(*events));
+    }
+    events[event_count++] = ev;
+  }
+  fclose(f);
+  return true;
+}
+
+uint8_t sim_flash[PICO_FLASH_SIZE_BYTES];
+
+bool sim_init(const sim_config_t *config) {
+  cfg = *config;
+  ssd1306_emu_reset();
+
+  // Flash apagada, ou a imagem salva por uma execução anterior
+  memset(sim_flash, 0xFF, sizeof(sim_flash));
+  if (cfg.flash_path) {
+    FILE *f = fopen(cfg.flash_path, "rb");
+    if (f) {
+      size_t n = fread(sim_flash, 1, sizeof(sim_flash), f);
+      (void)n;
+      fclose(f);
+    }
+  }
+
+  // Antes da primeira entrada o joystick fica em repouso no centro
+  event_capacity = 64;
+  events = malloc(event_capacity * sizeof(*events));
+  events[0] = (sim_event_t){ .t_us = 0, .kind = EV_STEP, .x = 2048, .y = 2048 };
+  event_count = 1;
+  if (cfg.trace_path && !parse_trace(cfg.trace_path))
+    return false;
+
+  end_us = events[event_count - 1].t_us + SIM_TAIL_US;
+  for (size_t i = 0; i < event_count; ++i) {
+    if (events[i].kind == EV_END) {
+      end_us = events[i].t_us;
+      break;
+    }
+  }
+  if (cfg.duration_us)
+    end_us = cfg.duration_us;
+  return true;
+}
+
+uint64_t sim_now_us(void) {
+  return now_us;
+}
+
+uint16_t sim_adc_value(uint input, uint64_t t_us) {
+  if (input > 1)
+    return 0;
+
+  // Última leitura definida até t_us e, se houver, a rampa que parte dela
+  const sim_event_t *from = NULL;
+  const sim_event_t *to = NULL;
+  for (size_t i = 0; i < event_count; ++i) {
+    const sim_event_t *ev = &events[i];
+    if (ev->kind != EV_STEP && ev->kind != EV_RAMP)
+      continue;
+    if (ev->t_us <= t_us) {
+      from = ev;
+    } else {
+      if (ev->kind == EV_RAMP)
+        to = ev;
+      break;
+    }
+  }
+
+  uint16_t a = input ? from->y : from->x;
+  if (!to)
+    return a;
+  uint16_t b = input ? to->y : to->x;
+  int64_t span = to->t_us - from->t_us;
+  int64_t pos = t_us - from->t_us;
+  return a + ((int64_t)b - a) * pos / span;
+}
+
+static void dump_frame(void) {
+  uint32_t generation = ssd1306_emu_generation();
+  if (!cfg.frames_dir || generation == traffic.dumped_generation)
+    return;
+  traffic.dumped_generation = generation;
+
+  char path[512];
+  snprintf(path, sizeof(path), "%s/frame_%05lu.pbm", cfg.frames_dir, (unsigned long)traffic.frames);
+  if (!ssd1306_emu_write_pbm(path))
+    perror(path);
+  if (cfg.log)
+    fprintf(cfg.log, "%llu frame %lu\n", (unsigned long long)now_us, (unsigned long)traffic.frames);
+  traffic.frames++;
+}
+
+// Um press dura até o release seguinte do mesmo pino ou, sem ele, SIM_PRESS_US
+static uint64_t press_end_us(size_t index) {
+  const sim_event_t *press = &events[index];
+  for (size_t i = index + 1; i < event_count; ++i) {
+    if (events[i].gpio != press->gpio)
+      continue;
+    if (events[i].kind == EV_RELEASE)
+      return events[i].t_us;
+    if (events[i].kind == EV_PRESS)
+      break;
+  }
+  return press->t_us + SIM_PRESS_US;
+}
+
+// Próximo evento de botão dentro da simulação, ou NULL
+static const sim_event_t *next_button_event(void) {
+  for (; next_button < event_count; ++next_button) {
+    const sim_event_t *ev = &events[next_button];
+    if (ev->t_us >= end_us)
+      return NULL;
+    if (ev->kind == EV_PRESS || ev->kind == EV_RELEASE)
+      return ev;
+  }
+  return NULL;
+}
+
+static void fire_button(const sim_event_t *ev) {
+  bool press = ev->kind == EV_PRESS;
+  uint32_t edge = press ? GPIO_IRQ_EDGE_FALL : GPIO_IRQ_EDGE_RISE;
+  pressed_until[ev->gpio] = press ? press_end_us(next_button) : ev->t_us;
+  if (cfg.log)
+    fprintf(cfg.log, "%llu %s %u\n", (unsigned long long)now_us, press ? "press" : "release", ev->gpio);
+  if (irq_callback && (irq_events[ev->gpio] & edge))
+    irq_callback(ev->gpio, edge);
+}
+
+// Índice do alarme pendente mais próximo, ou -1
+static int next_alarm(void) {
+  int next = -1;
+  for (int i = 0; i < SIM_ALARMS; ++i)
+    if (alarms[i].id && (next < 0 || alarms[i].time_us < alarms[next].time_us))
+      next = i;
+  return next;
+}
+
+// Executa o callback como a IRQ do timer; o retorno positivo reagenda
+static void fire_alarm(int i) {
+  alarm_id_t id = alarms[i].id;
+  alarm_callback_t callback = alarms[i].callback;
+  void *user_data = alarms[i].user_data;
+  alarms[i].id = 0;
+  int64_t again = callback(id, user_data);
+  if (again > 0)
+    add_alarm_at(now_us + again, callback, user_data, true);
+}
+
+void sim_advance_us(uint64_t us) {
+  uint64_t target = now_us + us;
+
+  // Dispara bordas de botão e alarmes em ordem cronológica até o destino
+  for (;;) {
+    const sim_event_t *ev = next_button_event();
+    int alarm = next_alarm();
+    uint64_t t_button = ev ? ev->t_us : UINT64_MAX;
+    uint64_t t_alarm = alarm >= 0 ? alarms[alarm].time_us : UINT64_MAX;
+    uint64_t t = t_button <= t_alarm ? t_button : t_alarm;
+    if (t > target)
+      break;
+    if (t > now_us)
+      now_us = t;
+
+    if (t_button <= t_alarm) {
+      fire_button(ev);
+      next_button++;
+    } else {
+      fire_alarm(alarm);
+    }
+  }
+
+  now_us = target;
+}
+
+void sim_finish(void) {
+  dump_frame();
+  if (cfg.final_pbm && !ssd1306_emu_write_pbm(cfg.final_pbm))
+    perror(cfg.final_pbm);
+  if (cfg.flash_path) {
+    FILE *f = fopen(cfg.flash_path, "wb");
+    if (!f || fwrite(sim_flash, 1, sizeof(sim_flash), f) != sizeof(sim_flash))
+      perror(cfg.flash_path);
+    if (f)
+      fclose(f);
+  }
+
+  fprintf(stderr,
+          "sim: %.3f s simulados, %lu transacoes I2C, %llu bytes, barramento ocupado %.1f%%, "
+          "%lu quadros gravados\n",
+          now_us / 1e6, (unsigned long)traffic.transactions, (unsigned long long)traffic.bytes,
+          now_us ? 100.0 * traffic.busy_us / now_us : 0.0, (unsigned long)traffic.frames);
+  if (cfg.log)
+    fflush(cfg.log);
+  exit(0);
+}
+
+// ---- pico/stdlib.h ----
+
+uint32_t time_us_32(void) {
+  return (uint32_t)now_us;
+}
+
+uint64_t time_us_64(void) {
+  return now_us;
+}
+
+// Cada sleep ou __wfi fecha um quadro; a simulação só termina nessas fronteiras
+void sleep_us(uint64_t us) {
+  dump_frame();
+  sim_advance_us(us);
+  if (now_us >= end_us)
+    sim_finish();
+}
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+  if (time <= now_us) {
+    if (fire_if_past)
+      callback(0, user_data);
+    return 0;
+  }
+  for (size_t i = 0; i < SIM_ALARMS; ++i) {
+    if (!alarms[i].id) {
+      alarms[i].time_us = time;
+      alarms[i].callback = callback;
+      alarms[i].user_data = user_data;
+      alarms[i].id = next_alarm_id++;
+      return alarms[i].id;
+    }
+  }
+  return -1;
+}
+
+// Dorme até o alarme mais próximo (ou SIM_IDLE_US sem alarmes), que é
+// disparado por sim_advance_us como a IRQ do timer
+void __wfi(void) {
+  dump_frame();
+
+  int alarm = next_alarm();
+  uint64_t wake = now_us + SIM_IDLE_US;
+  if (alarm >= 0 && alarms[alarm].time_us < wake)
+    wake = alarms[alarm].time_us;
+  sim_advance_us(wake > now_us ? wake - now_us : 0);
+
+  if (now_us >= end_us)
+    sim_finish();
+}
+
+// Espera ativa consome tempo virtual, senão laços como ssd1306_wait nunca
+// veriam o fim de uma transferência
+void tight_loop_contents(void) {
+  sim_advance_us(1);
+}
+
+bool stdio_init_all(void) {
+  return true;
+}
+
+int putchar_raw(int c) {
+  return putchar(c);
+}
+
+void stdio_flush(void) {
+  fflush(stdout);
+}
+
+void gpio_init(uint gpio) {
+  (void)gpio;
+}
+
+void gpio_set_dir(uint gpio, bool out) {
+  if (gpio < SIM_GPIO_COUNT)
+    gpio_dir_out[gpio] = out;
+}
+
+void gpio_pull_up(uint gpio) {
+  (void)gpio;
+}
+
+void gpio_put(uint gpio, bool value) {
+  if (gpio >= SIM_GPIO_COUNT || gpio_out[gpio] == value)
+    return;
+  gpio_out[gpio] = value;
+  if (cfg.log)
+    fprintf(cfg.log, "%llu gpio %u %u\n", (unsigned long long)now_us, gpio, value);
+}
+
+// Entradas com pull-up: nível baixo apenas enquanto o botão está pressionado
+bool gpio_get(uint gpio) {
+  if (gpio >= SIM_GPIO_COUNT)
+    return false;
+  if (gpio_dir_out[gpio])
+    return gpio_out[gpio];
+  return now_us >= pressed_until[gpio];
+}
+
+void gpio_set_function(uint gpio, enum gpio_function fn) {
+  (void)gpio;
+  (void)fn;
+}
+
+void gpio_set_irq_enabled(uint gpio, uint32_t events_mask, bool enabled) {
+  if (gpio >= SIM_GPIO_COUNT)
+    return;
+  if (enabled)
+    irq_events[gpio] |= events_mask;
+  else
+    irq_events[gpio] &= ~events_mask;
+}
+
+void gpio_set_irq_enabled_with_callback(uint gpio, uint32_t events_mask, bool enabled,
+                                        gpio_irq_callback_t callback) {
+  gpio_set_irq_enabled(gpio, events_mask, enabled);
+  irq_callback = callback;
+}
+
+// ---- pico/stdio_usb.h, tusb.h ----
+
+static void usb_out_chars(const char *buf, int len) {
+  fwrite(buf, 1, len, stdout);
+}
+
+static void usb_out_flush(void) {
+  fflush(stdout);
+}
+
+stdio_driver_t stdio_usb = { usb_out_chars, usb_out_flush };
+
+bool stdio_usb_connected(void) {
+  return true;
+}
+
+// O host consome tudo na hora: o FIFO está sempre vazio
+uint32_t tud_cdc_write_available(void) {
+  return SIM_CDC_TX_BUFSIZE;
+}
+
+// ---- pico/multicore.h ----
+
+void multicore_launch_core1(void (*entry)(void)) {
+  (void)entry;
+  fprintf(stderr, "sim: multicore indisponível, compile com DUAL_CORE=0\n");
+  abort();
+}
+
+// ---- hardware/adc.h ----
+
+void adc_init(void) {}
+
+void adc_gpio_init(uint gpio) {
+  (void)gpio;
+}
+
+void adc_select_input(uint input) {
+  adc_input = input;
+}
+
+uint16_t adc_read(void) {
+  return sim_adc_value(adc_input, now_us);
+}
+
+// ---- hardware/pwm.h ----
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {
+  (void)slice_num;
+  (void)wrap;
+}
+
+void pwm_set_enabled(uint slice_num, bool enabled) {
+  (void)slice_num;
+  (void)enabled;
+}
+
+void pwm_set_clkdiv(uint slice_num, float divider) {
+  (void)slice_num;
+  (void)divider;
+}
+
+void pwm_set_gpio_level(uint gpio, uint16_t level) {
+  if (gpio >= SIM_GPIO_COUNT || pwm_level[gpio] == level)
+    return;
+  pwm_level[gpio] = level;
+  if (cfg.log)
+    fprintf(cfg.log, "%llu pwm %u %u\n", (unsigned long long)now_us, gpio, level);
+}
+
+// ---- hardware/flash.h ----
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+  if (flash_offs % FLASH_SECTOR_SIZE || count % FLASH_SECTOR_SIZE || flash_offs + count > sizeof(sim_flash)) {
+    fprintf(stderr, "sim: apagamento da flash desalinhado ou fora da área (%u, %zu)\n", flash_offs, count);
+    abort();
+  }
+  memset(&sim_flash[flash_offs], 0xFF, count);
+  if (cfg.log)
+    fprintf(cfg.log, "%llu flash erase %x %zu\n", (unsigned long long)now_us, flash_offs, count);
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+  if (flash_offs % FLASH_PAGE_SIZE || count % FLASH_PAGE_SIZE || flash_offs + count > sizeof(sim_flash)) {
+    fprintf(stderr, "sim: programação da flash desalinhada ou fora da área (%u, %zu)\n", flash_offs, count);
+    abort();
+  }
+  // Programar só leva bits de 1 para 0
+  for (size_t i = 0; i < count; ++i)
+    sim_flash[flash_offs + i] &= data[i];
+  if (cfg.log)
+    fprintf(cfg.log, "%llu flash program %x %zu\n", (unsigned long long)now_us, flash_offs, count);
+}
+
+// ---- hardware/i2c.h ----
+
+uint i2c_init(i2c_inst_t *i2c, uint baudrate) {
+  i2c->baudrate = baudrate;
+  return baudrate;
+}
+
+uint64_t sim_i2c_transfer(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len) {
+  if (cfg.log) {
+    fprintf(cfg.log, "%llu i2c %02x %lu", (unsigned long long)now_us, addr, (unsigned long)len);
+    for (size_t i = 0; i < len; ++i)
+      fprintf(cfg.log, " %02x", src[i]);
+    fputc('\n', cfg.log);
+  }
+
+  ssd1306_emu_write(src, len);
+
+  uint64_t bus_us = i2c->baudrate ? (uint64_t)(len + 1) * 9 * 1000000 / i2c->baudrate : 0;
+  traffic.transactions++;
+  traffic.bytes += len + 1;
+  traffic.busy_us += bus_us;
+  return bus_us;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+  (void)nostop;
+  sim_advance_us(sim_i2c_transfer(i2c, addr, src, len));
+  return (int)len;
+}
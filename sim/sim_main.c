@@ -0,0 +1,51 @@
+#include "sim.h"
+#include <stdlib.h>
+#include <string.h>
+
+// main() do firmware, renomeado pela definição main=firmware_main do CMake
+int firmware_main(void);
+
+static void usage(const char *prog) {
+  fprintf(stderr,
+          "uso: %s [--trace roteiro.txt] [--frames dir] [--out final.pbm]\n"
+          "          [--log trafego.txt] [--duration ms] [--flash flash.bin]\n",
+          prog);
+}
+
+int main(int argc, char **argv) {
+  sim_config_t config = {0};
+
+  for (int i = 1; i < argc; ++i) {
+    const char *arg = argv[i];
+    const char *value = i + 1 < argc ? argv[i + 1] : NULL;
+    if (!value) {
+      usage(argv[0]);
+      return 2;
+    }
+    if (strcmp(arg, "--trace") == 0) {
+      config.trace_path = value;
+    } else if (strcmp(arg, "--frames") == 0) {
+      config.frames_dir = value;
+    } else if (strcmp(arg, "--out") == 0) {
+      config.final_pbm = value;
+    } else if (strcmp(arg, "--log") == 0) {
+      config.log = fopen(value, "w");
+      if (!config.log) {
+        perror(value);
+        return 1;
+      }
+    } else if (strcmp(arg, "--flash") == 0) {
+      config.flash_path = value;
+    } else if (strcmp(arg, "--duration") == 0) {
+      config.duration_us = strtoull(value, NULL, 10) * 1000;
+    } else {
+      usage(argv[0]);
+      return 2;
+    }
+    ++i;
+  }
+
+  if (!sim_init(&config))
+    return 1;
+  return firmware_main();
+}
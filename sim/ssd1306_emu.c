@@ -0,0 +1,156 @@
+#include "ssd1306_emu.h"
+#include <stdio.h>
+#include <string.h>
+
+static uint8_t gddram[SSD1306_EMU_WIDTH * SSD1306_EMU_PAGES];
+static uint32_t generation;
+
+static struct {
+  uint8_t mode;                 // 0 horizontal, 1 vertical, 2 por página
+  uint8_t c0, c1, p0, p1;       // janela de endereçamento
+  uint8_t col, page;            // ponteiro atual
+  bool seg_remap, com_remap;
+  bool inverted, entire_on, on;
+  uint8_t cmd;                  // comando aguardando argumentos
+  uint8_t argc, argn, args[6];
+} st;
+
+void ssd1306_emu_reset(void) {
+  memset(gddram, 0, sizeof(gddram));
+  memset(&st, 0, sizeof(st));
+  st.mode = 2;
+  st.c1 = SSD1306_EMU_WIDTH - 1;
+  st.p1 = SSD1306_EMU_PAGES - 1;
+  generation = 0;
+}
+
+// Quantidade de argumentos de cada comando de vários bytes
+static uint8_t cmd_args(uint8_t cmd) {
+  switch (cmd) {
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+      return 1;
+    case 0x21: case 0x22: case 0xA3:
+      return 2;
+    case 0x29: case 0x2A:
+      return 5;
+    case 0x26: case 0x27:
+      return 6;
+    default:
+      return 0;
+  }
+}
+
+static void run_cmd(uint8_t cmd, const uint8_t *args) {
+  if (cmd == 0x20) {
+    st.mode = args[0] & 0x03;
+  } else if (cmd == 0x21) {
+    st.c0 = st.col = args[0] & 0x7F;
+    st.c1 = args[1] & 0x7F;
+  } else if (cmd == 0x22) {
+    st.p0 = st.page = args[0] & 0x07;
+    st.p1 = args[1] & 0x07;
+  } else if (cmd <= 0x0F) {
+    st.col = (st.col & 0xF0) | cmd;
+  } else if (cmd <= 0x1F) {
+    st.col = ((cmd & 0x07) << 4) | (st.col & 0x0F);
+  } else if ((cmd & 0xF8) == 0xB0) {
+    st.page = cmd & 0x07;
+  } else if ((cmd & 0xFE) == 0xA0) {
+    st.seg_remap = cmd & 0x01;
+  } else if ((cmd & 0xF7) == 0xC0) {
+    st.com_remap = cmd & 0x08;
+  } else if ((cmd & 0xFE) == 0xA4) {
+    st.entire_on = cmd & 0x01;
+  } else if ((cmd & 0xFE) == 0xA6) {
+    st.inverted = cmd & 0x01;
+  } else if ((cmd & 0xFE) == 0xAE) {
+    st.on = cmd & 0x01;
+  }
+}
+
+static void emu_cmd(uint8_t b) {
+  if (st.argn < st.argc) {
+    st.args[st.argn++] = b;
+    if (st.argn == st.argc)
+      run_cmd(st.cmd, st.args);
+    return;
+  }
+  st.cmd = b;
+  st.argc = cmd_args(b);
+  st.argn = 0;
+  if (!st.argc)
+    run_cmd(b, NULL);
+}
+
+static void emu_data(uint8_t b) {
+  gddram[st.col * SSD1306_EMU_PAGES + st.page] = b;
+  generation++;
+
+  if (st.mode == 1) {
+    if (st.page++ >= st.p1) {
+      st.page = st.p0;
+      st.col = st.col >= st.c1 ? st.c0 : st.col + 1;
+    }
+  } else if (st.mode == 0) {
+    if (st.col++ >= st.c1) {
+      st.col = st.c0;
+      st.page = st.page >= st.p1 ? st.p0 : st.page + 1;
+    }
+  } else if (st.col < SSD1306_EMU_WIDTH - 1) {
+    st.col++;
+  }
+}
+
+void ssd1306_emu_write(const uint8_t *src, size_t len) {
+  size_t i = 0;
+  while (i < len) {
+    uint8_t ctl = src[i++];
+    bool single = ctl & 0x80;
+    bool data = ctl & 0x40;
+    while (i < len) {
+      if (data)
+        emu_data(src[i++]);
+      else
+        emu_cmd(src[i++]);
+      if (single)
+        break;
+    }
+  }
+}
+
+uint32_t ssd1306_emu_generation(void) {
+  return generation;
+}
+
+// O firmware configura remapeamento de segmentos e varredura COM invertida
+// (0xA1/0xC8) para a montagem da BitDogLab; com eles a GDDRAM aparece no
+// painel na mesma orientação do framebuffer
+bool ssd1306_emu_pixel(uint8_t x, uint8_t y) {
+  if (!st.on)
+    return false;
+  if (st.entire_on)
+    return true;
+  uint8_t col = st.seg_remap ? x : SSD1306_EMU_WIDTH - 1 - x;
+  uint8_t row = st.com_remap ? y : SSD1306_EMU_PAGES * 8 - 1 - y;
+  bool lit = gddram[col * SSD1306_EMU_PAGES + row / 8] & (1u << (row % 8));
+  return lit != st.inverted;
+}
+
+bool ssd1306_emu_write_pbm(const char *path) {
+  FILE *f = fopen(path, "wb");
+  if (!f)
+    return false;
+
+  fprintf(f, "P4\n%d %d\n", SSD1306_EMU_WIDTH, SSD1306_EMU_PAGES * 8);
+  for (uint8_t y = 0; y < SSD1306_EMU_PAGES * 8; ++y) {
+    uint8_t row[SSD1306_EMU_WIDTH / 8] = {0};
+    for (uint8_t x = 0; x < SSD1306_EMU_WIDTH; ++x) {
+      // No PBM o bit 1 é preto: o fundo apagado do OLED
+      if (!ssd1306_emu_pixel(x, y))
+        row[x / 8] |= 0x80u >> (x % 8);
+    }
+    fwrite(row, 1, sizeof(row), f);
+  }
+  return fclose(f) == 0;
+}
@@ -0,0 +1,27 @@
+#ifndef SSD1306_EMU_H
+#define SSD1306_EMU_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Emulador da GDDRAM do SSD1306 (128x64) alimentado pelas transações I2C.
+// Interpreta os bytes de controle (0x80/0x00 comandos, 0xC0/0x40 dados), os
+// três modos de endereçamento e os comandos que afetam a imagem (remapeamento,
+// direção COM, inversão, liga/desliga)
+#define SSD1306_EMU_WIDTH 128
+#define SSD1306_EMU_PAGES 8
+
+void ssd1306_emu_reset(void);
+void ssd1306_emu_write(const uint8_t *src, size_t len);
+
+// Contador incrementado a cada byte de dados escrito na GDDRAM
+uint32_t ssd1306_emu_generation(void);
+
+// Pixel como visto no painel; aceso = true
+bool ssd1306_emu_pixel(uint8_t x, uint8_t y);
+
+// Grava a imagem do painel em PBM binário (P4): pixel aceso = branco
+bool ssd1306_emu_write_pbm(const char *path);
+
+#endif // SSD1306_EMU_H
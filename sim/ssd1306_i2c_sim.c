@@ -0,0 +1,54 @@
+#include "ssd1306_i2c.h"
+#include "sim.h"
+
+// Transporte do host. A escrita bloqueante usa i2c_write_blocking; a
+// assíncrona faz o papel do DMA: entrega os segmentos ao emulador na hora e
+// fica ocupada pelo tempo de barramento, chamando done em um alarme ao final
+static uint64_t busy_until;
+static ssd1306_xfer_cb_t pending_done;
+static void *pending_arg;
+
+static void sim_write(void *ctx, uint8_t address, const uint8_t *src, size_t len) {
+  i2c_write_blocking(ctx, address, src, len, false);
+}
+
+static bool sim_busy(void *ctx) {
+  (void)ctx;
+  return sim_now_us() < busy_until;
+}
+
+static int64_t sim_transfer_done(alarm_id_t id, void *arg) {
+  (void)id;
+  (void)arg;
+  ssd1306_xfer_cb_t done = pending_done;
+  pending_done = NULL;
+  if (done)
+    done(pending_arg, true);
+  return 0;
+}
+
+static bool sim_write_async(void *ctx, uint8_t address, const ssd1306_segment_t *segs, size_t count,
+                            ssd1306_xfer_cb_t done, void *arg) {
+  if (sim_busy(ctx))
+    return false;
+
+  uint64_t bus_us = 0;
+  for (size_t i = 0; i < count; ++i)
+    bus_us += sim_i2c_transfer(ctx, address, segs[i].data, segs[i].len);
+
+  busy_until = sim_now_us() + bus_us;
+  pending_done = done;
+  pending_arg = arg;
+  add_alarm_at(from_us_since_boot(busy_until), sim_transfer_done, NULL, true);
+  return true;
+}
+
+const ssd1306_transport_t ssd1306_i2c_transport = {
+  .write = sim_write,
+  .write_async = sim_write_async,
+  .busy = sim_busy,
+};
+
+void *ssd1306_i2c_context(i2c_inst_t *i2c) {
+  return i2c;
+}
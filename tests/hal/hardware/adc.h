@@ -0,0 +1,22 @@
+#ifndef TEST_HARDWARE_ADC_H
+#define TEST_HARDWARE_ADC_H
+
+#include "pico/stdlib.h"
+
+// ADC com FIFO e round-robin, a parte usada por inc/adc_sampler.c; as
+// chamadas só registram a configuração (o DMA falso gera as amostras)
+
+typedef struct {
+  volatile uint32_t fifo;
+} adc_hw_t;
+
+extern adc_hw_t *const adc_hw;
+
+void adc_select_input(uint input);
+void adc_set_round_robin(uint input_mask);
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift);
+void adc_set_clkdiv(float clkdiv);
+void adc_run(bool run);
+void adc_fifo_drain(void);
+
+#endif // TEST_HARDWARE_ADC_H
@@ -0,0 +1,37 @@
+#ifndef TEST_HARDWARE_DMA_H
+#define TEST_HARDWARE_DMA_H
+
+#include "pico/stdlib.h"
+
+// DMA falso para testar inc/adc_sampler.c: um único canal cujo contador de
+// transferências o teste avança (tests/test_adc_sampler.c)
+
+enum dma_channel_transfer_size { DMA_SIZE_8 = 0, DMA_SIZE_16 = 1, DMA_SIZE_32 = 2 };
+#define DREQ_ADC 36
+
+typedef struct {
+  uint32_t ctrl;
+  uint32_t ring_bits;
+} dma_channel_config;
+
+typedef struct {
+  volatile uint32_t transfer_count;
+} dma_channel_hw_t;
+
+int dma_claim_unused_channel(bool required);
+void dma_channel_set_irq1_enabled(uint channel, bool enabled);
+bool dma_channel_get_irq1_status(uint channel);
+void dma_channel_acknowledge_irq1(uint channel);
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger);
+dma_channel_hw_t *dma_channel_hw_addr(uint channel);
+dma_channel_config dma_channel_get_default_config(uint channel);
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size);
+void channel_config_set_read_increment(dma_channel_config *c, bool incr);
+void channel_config_set_write_increment(dma_channel_config *c, bool incr);
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits);
+void channel_config_set_dreq(dma_channel_config *c, uint dreq);
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger);
+void dma_channel_abort(uint channel);
+
+#endif // TEST_HARDWARE_DMA_H
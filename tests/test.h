@@ -0,0 +1,31 @@
+#ifndef TEST_H
+#define TEST_H
+
+#include <stdio.h>
+
+// Verificações dos testes do host: cada falha imprime a linha e é contada, e o
+// teste segue para mostrar todas as falhas. main termina com TEST_RESULT().
+
+static int test_failures;
+
+#define CHECK(cond)                                                        \
+  do {                                                                     \
+    if (!(cond)) {                                                         \
+      fprintf(stderr, "%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond);   \
+      test_failures++;                                                     \
+    }                                                                      \
+  } while (0)
+
+#define CHECK_EQ(a, b)                                                     \
+  do {                                                                     \
+    long long a_ = (long long)(a), b_ = (long long)(b);                    \
+    if (a_ != b_) {                                                        \
+      fprintf(stderr, "%s:%d: falhou: %s == %s (%lld != %lld)\n",          \
+              __FILE__, __LINE__, #a, #b, a_, b_);                         \
+      test_failures++;                                                     \
+    }                                                                      \
+  } while (0)
+
+#define TEST_RESULT() (test_failures ? (fprintf(stderr, "%d falha(s)\n", test_failures), 1) : 0)
+
+#endif // TEST_H
@@ -0,0 +1,214 @@
+#include "adc_sampler.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+#include "test.h"
+
+// Testa o leitor do anel de inc/adc_sampler.c sobre um DMA falso. O DMA
+// escreve no anel configurado a amostra de índice n com o valor do quadro
+// n / 2 (X) ou seu complemento (Y), então cada quadro lido diz de onde veio.
+
+#define FRAME_RATE 1000u
+// ADC_SAMPLER_BLOCK de inc/adc_sampler.c
+#define BLOCK (1u << 30)
+
+static struct {
+  dma_channel_hw_t hw;
+  uint16_t *ring;
+  uint32_t ring_samples;
+  uint64_t total;            // amostras escritas desde a configuração
+  bool irq_enabled, irq_pending;
+  irq_handler_t handler;
+  // Amostras escritas pelo DMA a cada leitura do contador pelo amostrador
+  uint32_t lap[4];
+  size_t laps;
+} dma;
+
+static adc_hw_t adc_regs;
+adc_hw_t *const adc_hw = &adc_regs;
+
+static uint16_t sample_value(uint64_t n) {
+  uint16_t frame = (uint16_t)(n / 2);
+  return n & 1 ? (uint16_t)~frame : frame;
+}
+
+static void dma_write(uint32_t samples) {
+  while (samples--) {
+    dma.ring[dma.total % dma.ring_samples] = sample_value(dma.total);
+    dma.total++;
+    if (--dma.hw.transfer_count == 0) {
+      dma.irq_pending = true;
+      if (dma.irq_enabled && dma.handler)
+        dma.handler();
+    }
+  }
+}
+
+// Avança o contador sem escrever no anel (o conteúdo dessas posições fica
+// velho e será sobrescrito antes de ser lido)
+static void dma_skip(uint32_t samples) {
+  dma.total += samples;
+  dma.hw.transfer_count -= samples;
+}
+
+uint64_t time_us_64(void) { return 0; }
+
+void adc_select_input(uint input) {}
+void adc_set_round_robin(uint input_mask) {}
+void adc_fifo_setup(bool en, bool dreq_en, uint16_t dreq_thresh, bool err_in_fifo, bool byte_shift) {}
+void adc_set_clkdiv(float clkdiv) {}
+void adc_run(bool run) {}
+void adc_fifo_drain(void) {}
+
+void irq_add_shared_handler(uint num, irq_handler_t handler, uint8_t order_priority) { dma.handler = handler; }
+void irq_set_enabled(uint num, bool enabled) {}
+
+int dma_claim_unused_channel(bool required) { return 0; }
+void dma_channel_set_irq1_enabled(uint channel, bool enabled) { dma.irq_enabled = enabled; }
+bool dma_channel_get_irq1_status(uint channel) { return dma.irq_pending; }
+void dma_channel_acknowledge_irq1(uint channel) { dma.irq_pending = false; }
+void dma_channel_set_trans_count(uint channel, uint32_t trans_count, bool trigger) { dma.hw.transfer_count = trans_count; }
+
+dma_channel_hw_t *dma_channel_hw_addr(uint channel) {
+  // Cada leitura do contador pode ver o DMA adiantado
+  if (dma.laps) {
+    uint32_t samples = dma.lap[0];
+    for (size_t i = 1; i < dma.laps; ++i)
+      dma.lap[i - 1] = dma.lap[i];
+    dma.laps--;
+    dma_write(samples);
+  }
+  return &dma.hw;
+}
+
+dma_channel_config dma_channel_get_default_config(uint channel) { return (dma_channel_config){ 0 }; }
+void channel_config_set_transfer_data_size(dma_channel_config *c, enum dma_channel_transfer_size size) {}
+void channel_config_set_read_increment(dma_channel_config *c, bool incr) {}
+void channel_config_set_write_increment(dma_channel_config *c, bool incr) {}
+void channel_config_set_ring(dma_channel_config *c, bool write, uint size_bits) { c->ring_bits = size_bits; }
+void channel_config_set_dreq(dma_channel_config *c, uint dreq) {}
+
+void dma_channel_configure(uint channel, const dma_channel_config *config, volatile void *write_addr,
+                           const volatile void *read_addr, uint32_t transfer_count, bool trigger) {
+  dma.ring = (uint16_t *)write_addr;
+  dma.ring_samples = (1u << config->ring_bits) / sizeof(uint16_t);
+  dma.total = 0;
+  dma.hw.transfer_count = transfer_count;
+  dma.laps = 0;
+}
+
+void dma_channel_abort(uint channel) {}
+
+// Confere que os quadros vieram em sequência a partir de first, com o
+// conteúdo e o instante de cada um
+static void check_frames(const adc_frame_t *frames, size_t count, uint64_t first) {
+  for (size_t i = 0; i < count; ++i) {
+    uint64_t n = first + i;
+    CHECK_EQ(frames[i].x, sample_value(2 * n));
+    CHECK_EQ(frames[i].y, sample_value(2 * n + 1));
+    CHECK_EQ(frames[i].timestamp_us, n * (1000000u / FRAME_RATE));
+  }
+}
+
+static adc_frame_t frames[ADC_SAMPLER_RING_SAMPLES];
+
+static void test_read(void) {
+  adc_sampler_start();
+  CHECK_EQ(dma.ring_samples, ADC_SAMPLER_RING_SAMPLES);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 0);
+
+  adc_frame_t latest;
+  CHECK(!adc_sampler_latest(&latest));
+
+  // 10 quadros e meio: o X sem o Y ainda não é entregue
+  dma_write(21);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 10);
+  check_frames(frames, 10, 0);
+  CHECK(adc_sampler_latest(&latest));
+  check_frames(&latest, 1, 9);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 0);
+
+  // Leitura limitada por max continua de onde parou
+  dma_write(9);
+  CHECK_EQ(adc_sampler_read(frames, 3), 3);
+  check_frames(frames, 3, 10);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 2);
+  check_frames(frames, 2, 13);
+  CHECK_EQ(adc_sampler_overruns(), 0);
+}
+
+static void test_ring_wrap(void) {
+  adc_sampler_start();
+  dma_write(500);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 250);
+
+  // Os quadros seguintes atravessam o fim do anel (512 amostras)
+  dma_write(40);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 20);
+  check_frames(frames, 20, 250);
+  CHECK_EQ(adc_sampler_overruns(), 0);
+}
+
+static void test_overrun_before_read(void) {
+  adc_sampler_start();
+  // O leitor ficou mais de uma volta para trás: fica com os quadros mais
+  // novos que cabem no anel, menos a folga do quadro em escrita
+  dma_write(1200);
+  size_t count = adc_sampler_read(frames, count_of(frames));
+  CHECK_EQ(count, (ADC_SAMPLER_RING_SAMPLES - 2) / 2);
+  check_frames(frames, count, 600 - count);
+  CHECK_EQ(adc_sampler_overruns(), 600 - count);
+
+  dma_write(10);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 5);
+  check_frames(frames, 5, 600);
+}
+
+static void test_lap_during_copy(void) {
+  adc_sampler_start();
+  dma_write(200);
+
+  // Entre a leitura do contador e a conferência final o DMA escreve mais 400
+  // amostras: as 88 primeiras copiadas já foram sobrescritas no anel real
+  dma.lap[0] = 0;
+  dma.lap[1] = 400;
+  dma.laps = 2;
+  size_t count = adc_sampler_read(frames, count_of(frames));
+  CHECK_EQ(count, 100 - 44);
+  check_frames(frames, count, 44);
+  CHECK_EQ(adc_sampler_overruns(), 44);
+
+  // O que foi escrito durante a cópia vem na leitura seguinte, sem perdas
+  count = adc_sampler_read(frames, count_of(frames));
+  CHECK_EQ(count, 200);
+  check_frames(frames, count, 100);
+  CHECK_EQ(adc_sampler_overruns(), 44);
+}
+
+static void test_block_epoch(void) {
+  adc_sampler_start();
+  // Perto do fim do bloco do DMA: a interrupção rearma o canal e conta a
+  // época, e o total de amostras segue contínuo
+  dma_skip(BLOCK - 600);
+  dma_write(560);
+  size_t count = adc_sampler_read(frames, count_of(frames));
+  uint64_t next = (BLOCK - 40) / 2;
+  check_frames(frames, count, next - count);
+
+  dma_write(80);
+  CHECK_EQ(dma.hw.transfer_count, BLOCK - 40);
+  CHECK_EQ(adc_sampler_read(frames, count_of(frames)), 40);
+  check_frames(frames, 40, next);
+}
+
+int main(void) {
+  adc_sampler_init(FRAME_RATE);
+  CHECK_EQ(adc_sampler_frame_rate(), FRAME_RATE);
+
+  test_read();
+  test_ring_wrap();
+  test_overrun_before_read();
+  test_lap_during_copy();
+  test_block_epoch();
+  return TEST_RESULT();
+}
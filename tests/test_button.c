@@ -0,0 +1,226 @@
+#include "button.h"
+#include "spsc_queue.h"
+#include "test.h"
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+// Testa a fila de bordas e a máquina de estados dos botões de inc/button.c
+// com o relógio e os níveis dos pinos falsos, e a fila SPSC de
+// inc/spsc_queue.c com um produtor e um consumidor em threads
+
+#define PIN_A 5
+#define PIN_B 6
+#define MS 1000u
+
+static uint32_t clock_us;
+static bool released[32] = { [PIN_A] = true, [PIN_B] = true };
+
+uint32_t time_us_32(void) {
+  return clock_us;
+}
+
+bool gpio_get(uint gpio) {
+  return released[gpio];
+}
+
+// Gestos recebidos, como "a:press a:release"
+static char gestures[1024];
+
+static void record(uint pin, button_gesture_t gesture) {
+  static const char *const names[] = {
+    [BUTTON_PRESS] = "press",
+    [BUTTON_RELEASE] = "release",
+    [BUTTON_LONG_PRESS] = "long",
+    [BUTTON_DOUBLE_CLICK] = "double",
+    [BUTTON_CLICK] = "click",
+  };
+  size_t len = strlen(gestures);
+  snprintf(gestures + len, sizeof(gestures) - len, "%s%c:%s", len ? " " : "", pin == PIN_A ? 'a' : 'b',
+           names[gesture]);
+}
+
+static button_t buttons[2];
+
+static void start(void) {
+  clock_us = 0;
+  released[PIN_A] = released[PIN_B] = true;
+  gestures[0] = '\0';
+  button_queue_init();
+  button_init(&buttons[0], PIN_A);
+  button_init(&buttons[1], PIN_B);
+  // O estado inicial é aceito só depois do intervalo de debounce
+  clock_us = BUTTON_DEBOUNCE_US;
+}
+
+// Borda no pino no instante t, como a IRQ a veria
+static void edge(uint pin, uint32_t t, bool press) {
+  clock_us = t;
+  released[pin] = !press;
+  CHECK(button_queue_edge(pin, press ? GPIO_IRQ_EDGE_FALL : GPIO_IRQ_EDGE_RISE));
+}
+
+// Despacha em t e confere os gestos emitidos desde o último despacho
+static void dispatch(uint32_t t, const char *expected) {
+  clock_us = t;
+  gestures[0] = '\0';
+  button_dispatch(buttons, count_of(buttons), t, record);
+  if (strcmp(gestures, expected) != 0) {
+    fprintf(stderr, "em %u us: \"%s\", esperado \"%s\"\n", t, gestures, expected);
+    test_failures++;
+  }
+}
+
+// Pressão curta isolada: o clique só sai depois da janela do duplo clique
+static void test_click(void) {
+  start();
+  edge(PIN_A, 100 * MS, true);
+  edge(PIN_A, 200 * MS, false);
+  dispatch(210 * MS, "a:press a:release");
+  dispatch(200 * MS + BUTTON_DOUBLE_CLICK_US, "");
+  dispatch(201 * MS + BUTTON_DOUBLE_CLICK_US, "a:click");
+  dispatch(2000 * MS, "");
+}
+
+// Repique dentro do intervalo de debounce não gera gestos
+static void test_debounce(void) {
+  start();
+  edge(PIN_A, 100 * MS, true);
+  edge(PIN_A, 105 * MS, false);
+  edge(PIN_A, 110 * MS, true);
+  dispatch(112 * MS, "a:press");
+  dispatch(150 * MS, "");
+
+  // Repique na soltura que termina solto: a borda de subida que passou o
+  // debounce solta, e o nível do pino confirma
+  edge(PIN_A, 300 * MS, false);
+  edge(PIN_A, 302 * MS, true);
+  edge(PIN_A, 304 * MS, false);
+  dispatch(340 * MS, "a:release");
+}
+
+static void test_double_click(void) {
+  start();
+  edge(PIN_A, 100 * MS, true);
+  edge(PIN_A, 200 * MS, false);
+  edge(PIN_A, 400 * MS, true);
+  dispatch(410 * MS, "a:press a:release a:press a:double");
+  edge(PIN_A, 500 * MS, false);
+  dispatch(510 * MS, "a:release");
+  // A pressão que completou o duplo clique não arma um clique
+  dispatch(2000 * MS, "");
+
+  // Segunda pressão depois da janela: dois cliques separados
+  edge(PIN_A, 3000 * MS, true);
+  edge(PIN_A, 3100 * MS, false);
+  dispatch(3100 * MS + BUTTON_DOUBLE_CLICK_US + 1, "a:press a:release a:click");
+  edge(PIN_A, 3200 * MS + BUTTON_DOUBLE_CLICK_US, true);
+  dispatch(3210 * MS + BUTTON_DOUBLE_CLICK_US, "a:press");
+}
+
+static void test_long_press(void) {
+  start();
+  edge(PIN_A, 100 * MS, true);
+  dispatch(100 * MS + BUTTON_LONG_PRESS_US - 1, "a:press");
+  dispatch(100 * MS + BUTTON_LONG_PRESS_US, "a:long");
+  dispatch(3000 * MS, "");
+  // Depois da pressão longa não há clique
+  edge(PIN_A, 3100 * MS, false);
+  dispatch(3110 * MS, "a:release");
+  dispatch(5000 * MS, "");
+}
+
+// Os gestos vão para o botão do pino da borda; pinos desconhecidos são ignorados
+static void test_pins(void) {
+  start();
+  edge(PIN_B, 100 * MS, true);
+  edge(PIN_A, 120 * MS, true);
+  clock_us = 130 * MS;
+  CHECK(button_queue_edge(17, GPIO_IRQ_EDGE_FALL));
+  edge(PIN_B, 200 * MS, false);
+  dispatch(210 * MS, "b:press a:press b:release");
+}
+
+// Fila cheia: as bordas excedentes se perdem e são contadas, e o nível dos
+// pinos corrige o estado no despacho
+static void test_overflow(void) {
+  start();
+  for (int i = 0; i < BUTTON_QUEUE_SIZE; ++i)
+    edge(PIN_B, (100 + 40 * i) * MS, i % 2 == 0);
+  CHECK_EQ(button_queue_overflows(), 0);
+
+  clock_us = 2000 * MS;
+  released[PIN_A] = false;
+  CHECK(!button_queue_edge(PIN_A, GPIO_IRQ_EDGE_FALL));
+  CHECK_EQ(button_queue_overflows(), 1);
+
+  gestures[0] = '\0';
+  button_dispatch(buttons, count_of(buttons), 2010 * MS, record);
+  CHECK(strstr(gestures, "a:press") != NULL);
+  CHECK(buttons[0].pressed);
+  CHECK(!buttons[1].pressed);
+}
+
+// Produtor e consumidor concorrentes: tudo chega, em ordem e inteiro. Com a
+// fila vazia ou cheia cada lado cede a CPU, para rodar também com um núcleo
+#define SPSC_COUNT 100000u
+
+typedef struct {
+  uint32_t seq;
+  uint32_t check;
+} spsc_msg_t;
+
+static spsc_queue_t spsc;
+static spsc_msg_t spsc_storage[64];
+
+static void *spsc_producer(void *arg) {
+  for (uint32_t i = 0; i < SPSC_COUNT;) {
+    spsc_msg_t m = { i, ~i * 2654435761u };
+    if (spsc_queue_push(&spsc, &m))
+      ++i;
+    else
+      sched_yield();
+  }
+  return NULL;
+}
+
+static void test_spsc_threads(void) {
+  spsc_queue_init(&spsc, spsc_storage, sizeof(spsc_msg_t), count_of(spsc_storage));
+  CHECK(spsc_queue_empty(&spsc));
+
+  pthread_t producer;
+  pthread_create(&producer, NULL, spsc_producer, NULL);
+  uint32_t next = 0;
+  bool ordered = true;
+  while (next < SPSC_COUNT) {
+    spsc_msg_t m;
+    if (!spsc_queue_pop(&spsc, &m)) {
+      sched_yield();
+      continue;
+    }
+    ordered &= m.seq == next && m.check == ~next * 2654435761u;
+    ++next;
+  }
+  pthread_join(producer, NULL);
+  CHECK(ordered);
+  CHECK(spsc_queue_empty(&spsc));
+
+  // Capacidade: cheia recusa até um elemento sair
+  spsc_msg_t m = { 0 };
+  for (size_t i = 0; i < count_of(spsc_storage); ++i)
+    CHECK(spsc_queue_push(&spsc, &m));
+  CHECK(!spsc_queue_push(&spsc, &m));
+  CHECK(spsc_queue_pop(&spsc, &m));
+  CHECK(spsc_queue_push(&spsc, &m));
+}
+
+int main(void) {
+  test_click();
+  test_debounce();
+  test_double_click();
+  test_long_press();
+  test_pins();
+  test_overflow();
+  test_spsc_threads();
+  return TEST_RESULT();
+}
@@ -0,0 +1,221 @@
+#include "joystick_cal.h"
+#include "joystick_filter.h"
+#include "joystick_lut.h"
+#include "hardware/flash.h"
+#include "pico/stdlib.h"
+#include "test.h"
+#include <string.h>
+
+// Testa o mapeamento do perfil de calibração contra funções de referência
+// por eixo, escritas direto da regra (sem as escalas em ponto fixo), e o
+// registro do perfil na flash emulada de sim/
+
+#define LEVEL_MAX 4095
+
+// Perfis: o padrão e um calibrado com centro e curso assimétricos
+static const joystick_cal_axis_t axes[] = {
+  { JOYSTICK_CENTER_X, 0, 4095, JOYSTICK_DEADZONE },
+  { 1987, 112, 4011, 96 },
+  { 2210, 301, 3890, 180 },
+};
+
+// Nível linear: o curso de cada lado, a partir da distância em que a zona
+// morta do filtro fecha, cobre 0..LEVEL_MAX
+static uint32_t ref_level(const joystick_cal_axis_t *axis, uint16_t value) {
+  if (value < axis->min) value = axis->min;
+  if (value > axis->max) value = axis->max;
+  int32_t release = axis->deadzone - JOYSTICK_HYSTERESIS;
+  int32_t diff = (int32_t)value - axis->center;
+  int32_t span = diff < 0 ? axis->center - axis->min - release : axis->max + 1 - axis->center - release;
+  if (diff < 0)
+    diff = -diff;
+  if (diff < release)
+    return 0;
+  uint32_t level = (uint32_t)(diff - release) * LEVEL_MAX / (uint32_t)span;
+  return level > LEVEL_MAX ? LEVEL_MAX : level;
+}
+
+static uint8_t ref_position(const joystick_cal_axis_t *axis, uint16_t value, uint8_t limit, bool invert) {
+  if (value < axis->min) value = axis->min;
+  if (value > axis->max) value = axis->max;
+  uint32_t offset = invert ? axis->max - value : value - axis->min;
+  return (uint8_t)(offset * (limit - 8u) / (axis->max - axis->min));
+}
+
+// As escalas Q20/Q24 arredondam para cima: até um nível de diferença
+static bool pwm_matches(const joystick_cal_axis_t *axis, uint16_t value, uint16_t pwm) {
+  uint32_t level = ref_level(axis, value);
+  return pwm >= lut_gamma[level > 0 ? level - 1 : 0] && pwm <= lut_gamma[level < LEVEL_MAX ? level + 1 : LEVEL_MAX];
+}
+
+static void test_map_reference(void) {
+  for (size_t a = 0; a < count_of(axes); ++a) {
+    const joystick_cal_axis_t *axis = &axes[a];
+    joystick_map_t map;
+    joystick_map_init(&map, axis, 64, true);
+
+    bool pwm_ok = true, pos_ok = true;
+    for (uint32_t v = 0; v <= 4095; ++v) {
+      uint16_t pwm = joystick_map_pwm(&map, v);
+      if (!pwm_matches(axis, v, pwm)) {
+        fprintf(stderr, "perfil %zu, leitura %u: pwm %u, nível de referência %u\n", a, v, pwm, ref_level(axis, v));
+        pwm_ok = false;
+      }
+      int32_t pos = joystick_map_position(&map, v) - ref_position(axis, v, 64, true);
+      pos_ok &= pos >= 0 && pos <= 1;
+    }
+    CHECK(pwm_ok);
+    CHECK(pos_ok);
+    CHECK_EQ(joystick_map_pwm(&map, axis->center), 0);
+    CHECK_EQ(joystick_map_pwm(&map, axis->min), lut_gamma[LEVEL_MAX]);
+  }
+}
+
+// Com a zona morta aberta, as leituras entre deadzone - histerese e deadzone
+// estão na rampa: o mapeamento não reaplica a zona morta do filtro
+static void test_map_follows_gate(void) {
+  joystick_cal_t cal;
+  joystick_cal_default(&cal);
+  joystick_map_t map;
+  joystick_map_init(&map, &cal.x, 128, false);
+  CHECK_EQ(map.release, JOYSTICK_DEADZONE - JOYSTICK_HYSTERESIS);
+
+  joystick_filter_t f;
+  joystick_filter_init(&f, cal.x.center);
+  f.value = cal.x.center + JOYSTICK_DEADZONE + JOYSTICK_HYSTERESIS + 1;
+  uint16_t open = joystick_map_pwm(&map, joystick_filter_gated(&f));
+  CHECK(f.active);
+
+  uint16_t prev = open;
+  bool on_ramp = true;
+  for (int d = JOYSTICK_DEADZONE + JOYSTICK_HYSTERESIS; d >= JOYSTICK_DEADZONE - JOYSTICK_HYSTERESIS; --d) {
+    f.value = cal.x.center + d;
+    uint16_t gated = joystick_filter_gated(&f);
+    on_ramp &= f.active && gated == f.value;
+    uint16_t pwm = joystick_map_pwm(&map, gated);
+    on_ramp &= pwm <= prev && pwm_matches(&cal.x, gated, pwm);
+    prev = pwm;
+  }
+  CHECK(on_ramp);
+  CHECK(open > 0);
+
+  // Abaixo de release a zona morta fecha e o nível é 0
+  f.value = cal.x.center + JOYSTICK_DEADZONE - JOYSTICK_HYSTERESIS - 1;
+  CHECK_EQ(joystick_map_pwm(&map, joystick_filter_gated(&f)), 0);
+  CHECK(!f.active);
+}
+
+// Setor do perfil: o último da flash, um registro por página
+#define CAL_SECTOR (&sim_flash[PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE])
+#define CAL_SLOTS (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+
+static joystick_cal_record_t *slot_record(uint32_t slot) {
+  return (joystick_cal_record_t *)&CAL_SECTOR[slot * FLASH_PAGE_SIZE];
+}
+
+static bool slot_erased(uint32_t slot) {
+  for (uint32_t i = 0; i < FLASH_PAGE_SIZE; ++i)
+    if (CAL_SECTOR[slot * FLASH_PAGE_SIZE + i] != 0xFF)
+      return false;
+  return true;
+}
+
+// Perfil distinto para cada n
+static joystick_cal_t profile(uint16_t n) {
+  return (joystick_cal_t){ { 2000 + n, 100, 4000, 80 }, { 2100 - n, 90, 3990, 96 } };
+}
+
+static bool same_cal(const joystick_cal_t *a, const joystick_cal_t *b) {
+  return memcmp(a, b, sizeof(*a)) == 0;
+}
+
+static void test_crc32(void) {
+  // Valor de verificação do CRC-32 (IEEE 802.3)
+  CHECK_EQ(joystick_cal_crc32("123456789", 9), 0xCBF43926u);
+  CHECK_EQ(joystick_cal_crc32("", 0), 0);
+}
+
+static void test_flash_round_trip(void) {
+  memset(sim_flash, 0xFF, sizeof(sim_flash));
+  joystick_cal_t cal;
+  CHECK(!joystick_cal_load(&cal));
+
+  joystick_cal_t a = profile(1), b = profile(2);
+  CHECK(joystick_cal_save(&a));
+  CHECK(joystick_cal_load(&cal));
+  CHECK(same_cal(&cal, &a));
+
+  // O segundo registro vai para a página seguinte e passa a valer
+  CHECK(joystick_cal_save(&b));
+  CHECK(!slot_erased(0) && !slot_erased(1) && slot_erased(2));
+  CHECK(joystick_cal_load(&cal));
+  CHECK(same_cal(&cal, &b));
+  CHECK_EQ(slot_record(1)->crc, joystick_cal_crc32(slot_record(1), offsetof(joystick_cal_record_t, crc)));
+}
+
+// Registros inválidos são pulados e vale o último válido antes deles
+static void test_flash_invalid(void) {
+  memset(sim_flash, 0xFF, sizeof(sim_flash));
+  joystick_cal_t a = profile(1), b = profile(2), cal;
+  joystick_cal_save(&a);
+  joystick_cal_save(&b);
+
+  // Um bit do perfil trocado: o CRC não confere
+  slot_record(1)->cal.x.center ^= 0x10;
+  CHECK(joystick_cal_load(&cal));
+  CHECK(same_cal(&cal, &a));
+
+  // Outra versão, mesmo com o CRC certo
+  slot_record(0)->version = JOYSTICK_CAL_VERSION + 1;
+  slot_record(0)->crc = joystick_cal_crc32(slot_record(0), offsetof(joystick_cal_record_t, crc));
+  CHECK(!joystick_cal_load(&cal));
+
+  // Gravação interrompida depois de um registro válido: só o cabeçalho
+  joystick_cal_t c = profile(3);
+  CHECK(joystick_cal_save(&c));
+  CHECK(!slot_erased(2));
+  memset(slot_record(3), 0xFF, FLASH_PAGE_SIZE);
+  slot_record(3)->magic = JOYSTICK_CAL_MAGIC;
+  CHECK(joystick_cal_load(&cal));
+  CHECK(same_cal(&cal, &c));
+}
+
+// Com o setor cheio a gravação apaga e recomeça da primeira página
+static void test_flash_sector_full(void) {
+  memset(sim_flash, 0xFF, sizeof(sim_flash));
+  joystick_cal_t cal;
+  for (uint16_t n = 0; n < CAL_SLOTS; ++n) {
+    joystick_cal_t p = profile(n);
+    CHECK(joystick_cal_save(&p));
+  }
+  CHECK(!slot_erased(CAL_SLOTS - 1));
+  CHECK(joystick_cal_load(&cal));
+  joystick_cal_t last = profile(CAL_SLOTS - 1);
+  CHECK(same_cal(&cal, &last));
+
+  joystick_cal_t next = profile(100);
+  CHECK(joystick_cal_save(&next));
+  CHECK(!slot_erased(0));
+  bool rest_erased = true;
+  for (uint32_t slot = 1; slot < CAL_SLOTS; ++slot)
+    rest_erased &= slot_erased(slot);
+  CHECK(rest_erased);
+  CHECK(joystick_cal_load(&cal));
+  CHECK(same_cal(&cal, &next));
+
+  // O resto da flash não é tocado
+  bool outside = true;
+  for (size_t i = 0; i < PICO_FLASH_SIZE_BYTES - FLASH_SECTOR_SIZE; ++i)
+    outside &= sim_flash[i] == 0xFF;
+  CHECK(outside);
+}
+
+int main(void) {
+  test_map_reference();
+  test_map_follows_gate();
+  test_crc32();
+  test_flash_round_trip();
+  test_flash_invalid();
+  test_flash_sector_full();
+  return TEST_RESULT();
+}
@@ -0,0 +1,172 @@
+#include "joystick_filter.h"
+#include "test.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Testa o filtro dos eixos com os roteiros de ruído de tests/traces: em
+// repouso a saída com zona morta não se move, na borda da zona morta a
+// histerese não oscila e um movimento de verdade é seguido.
+// Uso: test-joystick-filter <diretório dos roteiros>
+
+#define CENTER 2048
+#define MAX_SAMPLES 8192
+#define PER_OUTPUT (1u << (2 * JOYSTICK_OVERSAMPLE_BITS))
+
+typedef struct {
+  uint16_t samples[MAX_SAMPLES];
+  size_t count;
+} trace_t;
+
+static trace_t rest, edge;
+
+// Amostras brutas separadas por espaços; '#' comenta até o fim da linha
+static bool load_trace(trace_t *trace, const char *dir, const char *name) {
+  char path[512];
+  snprintf(path, sizeof(path), "%s/%s", dir, name);
+  FILE *f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "não foi possível abrir %s\n", path);
+    return false;
+  }
+
+  char line[256];
+  trace->count = 0;
+  while (fgets(line, sizeof(line), f)) {
+    char *p = line;
+    if (strchr(p, '#'))
+      *strchr(p, '#') = '\0';
+    for (char *end; trace->count < MAX_SAMPLES; p = end) {
+      long v = strtol(p, &end, 10);
+      if (end == p)
+        break;
+      trace->samples[trace->count++] = (uint16_t)v;
+    }
+  }
+  fclose(f);
+  return trace->count >= PER_OUTPUT;
+}
+
+// Ruído do repouso deslocado para outra posição do eixo
+static uint16_t rest_at(size_t i, int32_t target) {
+  int32_t v = (int32_t)rest.samples[i % rest.count] - 2051 + target;
+  return v < 0 ? 0 : v > 4095 ? 4095 : (uint16_t)v;
+}
+
+static void test_rest(void) {
+  joystick_filter_t f;
+  joystick_filter_init(&f, CENTER);
+
+  bool still = true;
+  int32_t worst = 0;
+  for (size_t i = 0; i < rest.count; ++i) {
+    if (!joystick_filter_push(&f, rest.samples[i]))
+      continue;
+    still &= joystick_filter_gated(&f) == CENTER;
+    int32_t dist = abs((int32_t)f.value - CENTER);
+    if (dist > worst)
+      worst = dist;
+  }
+  CHECK(still);
+  CHECK(worst < JOYSTICK_DEADZONE - JOYSTICK_HYSTERESIS);
+}
+
+// Trocas de estado da zona morta ao longo do roteiro da borda, a partir do
+// estado em que o filtro está
+static unsigned edge_toggles(joystick_filter_t *f, unsigned *plain_toggles) {
+  bool active = f->active;
+  bool outside = active;
+  unsigned toggles = 0;
+  *plain_toggles = 0;
+
+  for (size_t i = 0; i < edge.count; ++i) {
+    if (!joystick_filter_push(f, edge.samples[i]))
+      continue;
+    joystick_filter_gated(f);
+    toggles += f->active != active;
+    active = f->active;
+
+    // A mesma saída com um limiar simples, sem histerese
+    bool now_outside = abs((int32_t)f->value - CENTER) >= JOYSTICK_DEADZONE;
+    *plain_toggles += now_outside != outside;
+    outside = now_outside;
+  }
+  return toggles;
+}
+
+static void test_edge(void) {
+  joystick_filter_t f;
+  unsigned plain;
+
+  // Chegando do centro: a zona morta continua fechada
+  joystick_filter_init(&f, CENTER);
+  CHECK_EQ(edge_toggles(&f, &plain), 0);
+  CHECK(!f.active);
+  // O roteiro de fato cruza a borda: sem histerese a saída oscilaria
+  CHECK(plain > 4);
+
+  // Chegando de fora: continua aberta
+  joystick_filter_init(&f, CENTER);
+  for (size_t i = 0; i < 40 * PER_OUTPUT; ++i)
+    if (joystick_filter_push(&f, rest_at(i, CENTER + 400)))
+      joystick_filter_gated(&f);
+  CHECK(f.active);
+  CHECK_EQ(edge_toggles(&f, &plain), 0);
+  CHECK(f.active);
+}
+
+// Degrau até a ponta do eixo e de volta ao centro, com o ruído do repouso
+static void test_step(void) {
+  joystick_filter_t f;
+  joystick_filter_init(&f, CENTER);
+
+  const size_t step = 100, back = 300, settle = 20;
+  size_t outputs = 0;
+  bool followed = true, returned = true;
+  for (size_t i = 0; i < 400 * PER_OUTPUT; ++i) {
+    int32_t target = outputs >= step && outputs < back ? 3500 : CENTER;
+    if (!joystick_filter_push(&f, rest_at(i, target)))
+      continue;
+    uint16_t out = joystick_filter_gated(&f);
+    if (outputs >= step + settle && outputs < back)
+      followed &= abs((int32_t)out - 3500) <= 8;
+    if (outputs >= back + settle)
+      returned &= out == CENTER;
+    outputs++;
+  }
+  CHECK(followed);
+  CHECK(returned);
+}
+
+// Rampa lenta do centro até 4000: a saída acompanha com atraso limitado
+static void test_ramp(void) {
+  joystick_filter_t f;
+  joystick_filter_init(&f, CENTER);
+
+  const size_t length = 200;
+  int32_t worst = 0;
+  for (size_t i = 0; i < length * PER_OUTPUT; ++i) {
+    int32_t target = CENTER + (int32_t)((4000 - CENTER) * i / (length * PER_OUTPUT));
+    if (!joystick_filter_push(&f, rest_at(i, target)))
+      continue;
+    joystick_filter_gated(&f);
+    if (f.active) {
+      int32_t err = abs((int32_t)f.value - target);
+      if (err > worst)
+        worst = err;
+    }
+  }
+  CHECK(f.active);
+  CHECK(worst < 64);
+}
+
+int main(int argc, char **argv) {
+  const char *dir = argc > 1 ? argv[1] : "tests/traces";
+  if (!load_trace(&rest, dir, "joystick_rest.txt") || !load_trace(&edge, dir, "joystick_edge.txt"))
+    return 1;
+
+  test_rest();
+  test_edge();
+  test_step();
+  test_ramp();
+  return TEST_RESULT();
+}
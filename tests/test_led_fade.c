@@ -0,0 +1,185 @@
+#include "led_fade.h"
+#include "hardware/pwm.h"
+#include "sim.h"
+#include "test.h"
+
+// Testa o motor de fades de inc/led_fade.c sobre o transporte da simulação
+// (sim/led_fade_sim.c), com um relógio virtual e alarmes falsos: cada wrap do
+// PWM aplica uma entrada da tabela, e os níveis ficam nos pinos falsos
+
+#define PERIOD_US (1000000u / LED_FADE_STEP_HZ)
+#define MS 1000u
+#define LED_BLUE 12   // slice 6, canal A
+#define LED_RED 13    // slice 6, canal B
+#define LED_GREEN 11  // slice 5, canal B
+
+static uint64_t clock_us;
+static uint16_t level[32];
+
+uint64_t sim_now_us(void) {
+  return clock_us;
+}
+
+void pwm_set_wrap(uint slice_num, uint16_t wrap) {}
+void pwm_set_enabled(uint slice_num, bool enabled) {}
+void gpio_set_function(uint gpio, enum gpio_function fn) {}
+
+void pwm_set_gpio_level(uint gpio, uint16_t value) {
+  level[gpio] = value;
+}
+
+// Alarmes pendentes, disparados em ordem por advance_to
+static struct {
+  uint64_t at;
+  alarm_callback_t callback;
+  void *user_data;
+} alarms[4];
+static size_t alarm_count;
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+  alarms[alarm_count].at = time;
+  alarms[alarm_count].callback = callback;
+  alarms[alarm_count].user_data = user_data;
+  return (alarm_id_t)++alarm_count;
+}
+
+static void advance_to(uint64_t t) {
+  for (;;) {
+    size_t next = alarm_count;
+    for (size_t i = 0; i < alarm_count; ++i)
+      if (alarms[i].at <= t && (next == alarm_count || alarms[i].at < alarms[next].at))
+        next = i;
+    if (next == alarm_count)
+      break;
+    clock_us = alarms[next].at;
+    int64_t again = alarms[next].callback((alarm_id_t)(next + 1), alarms[next].user_data);
+    if (again > 0)
+      alarms[next].at += (uint64_t)again;
+    else
+      alarms[next] = alarms[--alarm_count];
+  }
+  clock_us = t;
+}
+
+// Avança n wraps e para no meio do período seguinte, longe das bordas
+static void wraps(unsigned n) {
+  advance_to((clock_us / PERIOD_US + n) * PERIOD_US + PERIOD_US / 2);
+}
+
+static led_fade_t fade;
+static int blue, red, green;
+
+static void start(void) {
+  advance_to(clock_us + 100 * MS);
+  CHECK_EQ(alarm_count, 0);
+  led_fade_init(&fade);
+  blue = led_fade_add(&fade, LED_BLUE);
+  red = led_fade_add(&fade, LED_RED);
+  green = led_fade_add(&fade, LED_GREEN);
+  level[LED_BLUE] = level[LED_RED] = level[LED_GREEN] = 0;
+}
+
+// Níveis da curva em 1/4, 1/2 e 3/4 de um fade de 0 a 4000 em 100 passos
+static void test_ease_levels(void) {
+  static const struct {
+    led_ease_t ease;
+    uint16_t at[3];
+  } curves[] = {
+    { LED_EASE_LINEAR, { 1000, 2000, 3000 } },
+    { LED_EASE_IN, { 250, 1000, 2250 } },
+    { LED_EASE_OUT, { 1750, 3000, 3750 } },
+    { LED_EASE_IN_OUT, { 625, 2000, 3375 } },
+  };
+  for (size_t c = 0; c < count_of(curves); ++c) {
+    start();
+    CHECK(led_fade_to(&fade, blue, 4000, 100 * MS, curves[c].ease));
+    for (int q = 0; q < 3; ++q) {
+      wraps(25);
+      CHECK_EQ(level[LED_BLUE], curves[c].at[q]);
+    }
+    wraps(25);
+    CHECK_EQ(level[LED_BLUE], 4000);
+  }
+  CHECK_EQ(led_fade_ease(100, 0, 1, 4, LED_EASE_LINEAR), 75);
+  CHECK_EQ(led_fade_ease(100, 0, 9, 4, LED_EASE_IN), 0);
+}
+
+// O nível final chega exatamente no wrap de número steps, e depois disso o
+// transporte para
+static void test_completion(void) {
+  start();
+  // Nada muda antes do primeiro wrap depois do pedido
+  CHECK(led_fade_to(&fade, blue, 4095, 100 * MS, LED_EASE_LINEAR));
+  CHECK_EQ(level[LED_BLUE], 0);
+  wraps(99);
+  CHECK(level[LED_BLUE] < 4095);
+  wraps(1);
+  CHECK_EQ(level[LED_BLUE], 4095);
+  wraps(10);
+  CHECK_EQ(level[LED_BLUE], 4095);
+  CHECK_EQ(alarm_count, 0);
+
+  // Alvo igual ao atual não reinicia; duração abaixo de um passo vale um passo
+  CHECK(!led_fade_to(&fade, blue, 4095, 100 * MS, LED_EASE_LINEAR));
+  CHECK(led_fade_to(&fade, blue, 10, 0, LED_EASE_LINEAR));
+  wraps(1);
+  CHECK_EQ(level[LED_BLUE], 10);
+  // Além do máximo a duração é truncada, e o nível, limitado ao wrap
+  CHECK(led_fade_to(&fade, blue, 60000, 5000 * MS, LED_EASE_LINEAR));
+  wraps(LED_FADE_MAX_STEPS);
+  CHECK_EQ(level[LED_BLUE], LED_FADE_WRAP);
+}
+
+// Novo alvo no meio do fade: parte do nível em vigor, sem salto. Durações
+// em potências de 2 deixam os níveis intermediários exatos
+static void test_retarget(void) {
+  start();
+  led_fade_to(&fade, blue, 4000, 128 * MS, LED_EASE_LINEAR);
+  wraps(32);
+  CHECK_EQ(level[LED_BLUE], 1000);
+
+  CHECK(led_fade_to(&fade, blue, 0, 8 * MS, LED_EASE_LINEAR));
+  CHECK_EQ(level[LED_BLUE], 1000);
+  CHECK_EQ(fade.channels[blue].from, 1000);
+  wraps(4);
+  CHECK_EQ(level[LED_BLUE], 500);
+  wraps(4);
+  CHECK_EQ(level[LED_BLUE], 0);
+}
+
+// Vermelho e azul dividem o slice 6: mudar o alvo de um não reinicia nem
+// atrasa o fade do outro, e o verde, em outro slice, não é afetado
+static void test_shared_slice(void) {
+  start();
+  led_fade_to(&fade, red, 4000, 128 * MS, LED_EASE_LINEAR);
+  led_fade_to(&fade, blue, 2000, 64 * MS, LED_EASE_LINEAR);
+  led_fade_to(&fade, green, 1000, 8 * MS, LED_EASE_LINEAR);
+  wraps(16);
+  CHECK_EQ(level[LED_RED], 500);
+  CHECK_EQ(level[LED_BLUE], 500);
+  CHECK_EQ(level[LED_GREEN], 1000);
+
+  led_fade_to(&fade, blue, 4000, 8 * MS, LED_EASE_LINEAR);
+  CHECK_EQ(level[LED_RED], 500);
+  wraps(8);
+  CHECK_EQ(level[LED_RED], 750);
+  CHECK_EQ(level[LED_BLUE], 4000);
+  CHECK_EQ(level[LED_GREEN], 1000);
+
+  // O vermelho muda de alvo; o azul, já parado, fica onde está
+  led_fade_to(&fade, red, 0, 16 * MS, LED_EASE_LINEAR);
+  wraps(8);
+  CHECK_EQ(level[LED_RED], 375);
+  CHECK_EQ(level[LED_BLUE], 4000);
+  wraps(8);
+  CHECK_EQ(level[LED_RED], 0);
+  CHECK_EQ(level[LED_BLUE], 4000);
+}
+
+int main(void) {
+  test_ease_levels();
+  test_completion();
+  test_retarget();
+  test_shared_slice();
+  return TEST_RESULT();
+}
@@ -0,0 +1,207 @@
+#include "scheduler.h"
+#include "pico/stdlib.h"
+#include "test.h"
+#include <string.h>
+
+// Testa os prazos, os descartes e a adaptação do período de inc/scheduler.c
+// com um relógio virtual: cada tarefa avança o relógio pelo seu custo
+
+static uint64_t clock_us;
+
+static uint64_t test_clock(void) {
+  return clock_us;
+}
+
+// O alarme de sched_wait é o que o __wfi falso espera
+static uint64_t alarm_at;
+static unsigned alarms;
+
+alarm_id_t add_alarm_at(absolute_time_t time, alarm_callback_t callback, void *user_data, bool fire_if_past) {
+  alarm_at = time;
+  alarms++;
+  return 1;
+}
+
+void __wfi(void) {
+  if (alarm_at > clock_us)
+    clock_us = alarm_at;
+}
+
+typedef struct {
+  char id;
+  uint32_t cost_us;
+  bool busy;               // devolve false, como com o barramento ocupado
+  uint32_t worst_late_us;  // maior atraso de início em relação ao prazo
+  const sched_task_t *task;
+} job_t;
+
+static char order[16];
+static size_t order_len;
+
+static bool job_run(void *arg) {
+  job_t *job = arg;
+  if (order_len < sizeof(order) - 1)
+    order[order_len++] = job->id;
+  if (job->task) {
+    uint64_t due = job->task->deadline_us - job->task->cur_period_us;
+    if (clock_us - due > job->worst_late_us)
+      job->worst_late_us = (uint32_t)(clock_us - due);
+  }
+  clock_us += job->cost_us;
+  return !job->busy;
+}
+
+static void start(scheduler_t *s) {
+  clock_us = 0;
+  order_len = 0;
+  order[0] = '\0';
+  sched_init(s, test_clock);
+}
+
+// Primeiro disparo imediato, em ordem de registro, e o próximo prazo devolvido
+static void test_deadlines(void) {
+  scheduler_t s;
+  start(&s);
+  job_t a = { .id = 'a' }, b = { .id = 'b' };
+  sched_task_t *ta = sched_add(&s, "a", 1000, job_run, &a);
+  sched_task_t *tb = sched_add(&s, "b", 2500, job_run, &b);
+  CHECK(ta && tb);
+
+  CHECK_EQ(sched_run(&s), 1000);
+  order[order_len] = '\0';
+  CHECK(strcmp(order, "ab") == 0);
+
+  // Antes do prazo nada roda
+  clock_us = 999;
+  CHECK_EQ(sched_run(&s), 1000);
+  CHECK_EQ(ta->runs, 1);
+
+  clock_us = 1000;
+  CHECK_EQ(sched_run(&s), 2000);
+  clock_us = 2500;
+  CHECK_EQ(sched_run(&s), 3000);
+  CHECK_EQ(ta->runs, 3);
+  CHECK_EQ(tb->runs, 2);
+  CHECK_EQ(ta->misses + tb->misses, 0);
+
+  // Período zero ou tabela cheia não registram
+  CHECK(sched_add(&s, "zero", 0, job_run, &a) == NULL);
+  for (size_t i = s.count; i < SCHED_MAX_TASKS; ++i)
+    CHECK(sched_add(&s, "x", 1000, job_run, &a) != NULL);
+  CHECK(sched_add(&s, "cheia", 1000, job_run, &a) == NULL);
+}
+
+// Atraso de vários períodos: uma execução só, os perdidos contados e o
+// próximo prazo mantém a fase
+static void test_missed_periods(void) {
+  scheduler_t s;
+  start(&s);
+  job_t a = { .id = 'a' };
+  sched_task_t *t = sched_add(&s, "a", 1000, job_run, &a);
+  sched_run(&s);
+
+  clock_us = 4500;
+  CHECK_EQ(sched_run(&s), 5000);
+  CHECK_EQ(t->runs, 2);
+  CHECK_EQ(t->misses, 3);
+
+  // Atraso menor que um período não é prazo perdido
+  clock_us = 5999;
+  CHECK_EQ(sched_run(&s), 6000);
+  CHECK_EQ(t->misses, 3);
+}
+
+// Execuções que não fazem o trabalho contam como descartes: o período dobra a
+// cada SCHED_ADAPT_DROPS seguidos, até o máximo, e volta pela metade a cada
+// SCHED_ADAPT_RECOVER execuções boas
+static void test_busy_adapts(void) {
+  scheduler_t s;
+  start(&s);
+  job_t a = { .id = 'a', .busy = true };
+  sched_task_t *t = sched_add(&s, "a", 1000, job_run, &a);
+  sched_set_droppable(t, 3000);
+
+  uint32_t periods[4];
+  for (size_t i = 0; i < count_of(periods); ++i) {
+    for (int n = 0; n < SCHED_ADAPT_DROPS; ++n)
+      clock_us = sched_run(&s);
+    periods[i] = t->cur_period_us;
+  }
+  CHECK_EQ(periods[0], 2000);
+  CHECK_EQ(periods[1], 3000);
+  CHECK_EQ(periods[2], 3000);
+  CHECK_EQ(t->drops, count_of(periods) * SCHED_ADAPT_DROPS);
+  CHECK_EQ(t->misses, 0);
+
+  a.busy = false;
+  for (int n = 0; n < SCHED_ADAPT_RECOVER - 1; ++n)
+    clock_us = sched_run(&s);
+  CHECK_EQ(t->cur_period_us, 3000);
+  clock_us = sched_run(&s);
+  CHECK_EQ(t->cur_period_us, 1500);
+  for (int n = 0; n < SCHED_ADAPT_RECOVER; ++n)
+    clock_us = sched_run(&s);
+  CHECK_EQ(t->cur_period_us, 1000);
+
+  // Tarefa fixa não adapta
+  start(&s);
+  sched_task_t *fixed = sched_add(&s, "f", 1000, job_run, &a);
+  a.busy = true;
+  for (int n = 0; n < 2 * SCHED_ADAPT_DROPS; ++n)
+    clock_us = sched_run(&s);
+  CHECK_EQ(fixed->cur_period_us, 1000);
+  CHECK_EQ(fixed->drops, 0);
+}
+
+// Carga acima da CPU: a tarefa descartável cede para a de maior prioridade,
+// que não perde prazos depois que a estimativa de custo converge
+static void test_drop_protects_priority(void) {
+  scheduler_t s;
+  start(&s);
+  job_t hi = { .id = 'h', .cost_us = 300 }, lo = { .id = 'l', .cost_us = 900 };
+  sched_task_t *th = sched_add(&s, "hi", 1000, job_run, &hi);
+  sched_task_t *tl = sched_add(&s, "lo", 1000, job_run, &lo);
+  sched_set_droppable(tl, 8000);
+  hi.task = th;
+
+  for (int n = 0; n < 200; ++n)
+    clock_us = sched_run(&s);
+  uint32_t warm_misses = th->misses, warm_runs = tl->runs;
+  hi.worst_late_us = 0;
+
+  while (clock_us < 1000000) {
+    uint64_t next = sched_run(&s);
+    if (next > clock_us)
+      clock_us = next;
+  }
+  CHECK_EQ(th->misses, warm_misses);
+  CHECK(hi.worst_late_us <= th->cur_period_us / 2 + lo.cost_us / 2);
+  CHECK(tl->drops > 0);
+  // Descartar não é deixar de rodar
+  CHECK(tl->runs > warm_runs + 100);
+  CHECK_EQ(th->cur_period_us, th->period_us);
+}
+
+// sched_wait arma o alarme no prazo e dorme até ele; prazo vencido volta direto
+static void test_wait(void) {
+  scheduler_t s;
+  start(&s);
+  alarms = 0;
+  clock_us = 100;
+  sched_wait(&s, 2500);
+  CHECK_EQ(alarms, 1);
+  CHECK_EQ(alarm_at, 2500);
+  CHECK_EQ(clock_us, 2500);
+
+  sched_wait(&s, 2000);
+  CHECK_EQ(alarms, 1);
+}
+
+int main(void) {
+  test_deadlines();
+  test_missed_periods();
+  test_busy_adapts();
+  test_drop_protects_priority();
+  test_wait();
+  return TEST_RESULT();
+}
@@ -0,0 +1,263 @@
+#include "ssd1306.h"
+#include "ssd1306_i2c.h"
+#include "ssd1306_emu.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+// Testa os caminhos de envio do driver contra o emulador da GDDRAM de sim/:
+// o transporte I2C é substituído por um que entrega cada transação ao
+// emulador e conta o tráfego no barramento
+
+#define WIDTH 128
+#define HEIGHT 64
+#define FRAMES 40
+
+static struct {
+  uint32_t transactions;
+  uint32_t bus_bytes;   // inclui o byte de endereço de cada transação
+} bus;
+
+static void mock_write(void *ctx, uint8_t address, const uint8_t *src, size_t len) {
+  ssd1306_emu_write(src, len);
+  bus.transactions++;
+  bus.bus_bytes += len + 1;
+}
+
+const ssd1306_transport_t ssd1306_i2c_transport = {
+  .write = mock_write,
+};
+
+// Transporte assíncrono que entrega na hora, ou recusa enquanto refuse. Com
+// abort_after >= 0 o barramento aborta depois desse número de transações,
+// como em um NACK: as seguintes se perdem e done informa a falha
+static bool refuse;
+static int abort_after = -1;
+
+static bool mock_write_async(void *ctx, uint8_t address, const ssd1306_segment_t *segs, size_t count,
+                             ssd1306_xfer_cb_t done, void *arg) {
+  if (refuse)
+    return false;
+  bool ok = abort_after < 0 || (size_t)abort_after >= count;
+  for (size_t i = 0; i < count && (ok || (int)i < abort_after); ++i)
+    mock_write(ctx, address, segs[i].data, segs[i].len);
+  done(arg, ok);
+  return true;
+}
+
+static const ssd1306_transport_t async_transport = {
+  .write = mock_write,
+  .write_async = mock_write_async,
+};
+
+void *ssd1306_i2c_context(i2c_inst_t *i2c) {
+  return i2c;
+}
+
+void tight_loop_contents(void) {}
+
+static uint8_t ram_buffer[SSD1306_BUFSIZE(WIDTH, HEIGHT)];
+static uint8_t scratch_buffer[SSD1306_SCRATCH_SIZE(WIDTH, HEIGHT)];
+
+static void display_init(ssd1306_t *ssd) {
+  ssd1306_emu_reset();
+  ssd1306_init(ssd, WIDTH, HEIGHT, false, 0x3C, NULL, ram_buffer, scratch_buffer);
+  bus.transactions = 0;
+  bus.bus_bytes = 0;
+}
+
+static bool fb_pixel(const ssd1306_t *ssd, uint8_t x, uint8_t y) {
+  return ssd->ram_buffer[x * ssd->pages + y / 8 + 1] & (1u << (y % 8));
+}
+
+// O painel emulado mostra exatamente o framebuffer
+static bool panel_matches(const ssd1306_t *ssd) {
+  for (uint8_t y = 0; y < HEIGHT; ++y)
+    for (uint8_t x = 0; x < WIDTH; ++x)
+      if (ssd1306_emu_pixel(x, y) != fb_pixel(ssd, x, y))
+        return false;
+  return true;
+}
+
+// Quadro i de uma sequência com mudanças pequenas e espalhadas: um cursor que
+// anda (apagado na posição anterior), um contador e uma barra que cresce
+static void draw_frame(ssd1306_t *ssd, int i) {
+  if (i > 0)
+    ssd1306_rect(ssd, ((i - 1) * 7) % 52 + 4, ((i - 1) * 13) % 112 + 8, 8, 8, false, true);
+  ssd1306_rect(ssd, (i * 7) % 52 + 4, (i * 13) % 112 + 8, 8, 8, true, true);
+
+  char text[8];
+  snprintf(text, sizeof(text), "%03d", i);
+  ssd1306_draw_string(ssd, text, 100, 0);
+  ssd1306_hline(ssd, 0, (uint8_t)(i * 3), 63, true);
+}
+
+typedef void (*send_fn_t)(ssd1306_t *ssd);
+
+// Desenha a sequência enviando cada quadro com send; retorna os bytes no
+// barramento e confere a tela emulada a cada quadro
+static uint32_t run_sequence(send_fn_t send) {
+  ssd1306_t ssd;
+  display_init(&ssd);
+
+  bool matches = true;
+  for (int i = 0; i < FRAMES; ++i) {
+    draw_frame(&ssd, i);
+    send(&ssd);
+    matches &= panel_matches(&ssd);
+  }
+  CHECK(matches);
+  return bus.bus_bytes;
+}
+
+// Sequências de comandos em uma transação: a configuração inteira (26
+// comandos e argumentos) e o quadro completo (janela + dados)
+static void test_batched_commands(void) {
+  ssd1306_t ssd;
+  ssd1306_emu_reset();
+  bus.transactions = 0;
+  bus.bus_bytes = 0;
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL, ram_buffer, scratch_buffer);
+  CHECK_EQ(bus.transactions, 1);
+  CHECK_EQ(bus.bus_bytes, 28);
+  CHECK_EQ(ssd.stats.transactions, bus.transactions);
+  CHECK_EQ(ssd.stats.bus_bytes, bus.bus_bytes);
+
+  bus.transactions = 0;
+  bus.bus_bytes = 0;
+  ssd1306_send_data(&ssd);
+  CHECK_EQ(bus.transactions, 2);
+  CHECK_EQ(bus.bus_bytes, 1 + 7 + 1 + SSD1306_BUFSIZE(WIDTH, HEIGHT));
+  CHECK_EQ(bus.bus_bytes, 1034);
+  CHECK_EQ(ssd.stats.bus_bytes, 28 + 1034);
+  CHECK(panel_matches(&ssd));
+}
+
+static void test_send_dirty(void) {
+  uint32_t full = run_sequence(ssd1306_send_data);
+  uint32_t dirty = run_sequence(ssd1306_send_dirty);
+  CHECK(dirty < full);
+
+  // Sem nada desenhado desde o último envio, nada vai ao barramento
+  ssd1306_t ssd;
+  display_init(&ssd);
+  draw_frame(&ssd, 0);
+  ssd1306_send_dirty(&ssd);
+  uint32_t before = bus.transactions;
+  ssd1306_send_dirty(&ssd);
+  CHECK_EQ(bus.transactions, before);
+  CHECK(panel_matches(&ssd));
+}
+
+// Envios maiores que um quadro não economizam nada (e não dão a volta)
+static void test_bytes_saved(void) {
+  ssd1306_t ssd;
+  display_init(&ssd);
+  ssd1306_reset_stats(&ssd);
+
+  const ssd1306_area_t halves[] = {
+    { 0, 0, 71, 63 },
+    { 56, 0, 127, 63 },
+  };
+  ssd1306_send_areas(&ssd, halves, count_of(halves));
+  CHECK_EQ(ssd.stats.bytes_sent, 2 + 144 * 8);
+  CHECK_EQ(ssd.stats.bytes_saved, 0);
+
+  const ssd1306_area_t corner = { 0, 0, 7, 7 };
+  ssd1306_send_areas(&ssd, &corner, 1);
+  CHECK_EQ(ssd.stats.bytes_saved, SSD1306_BUFSIZE(WIDTH, HEIGHT) - 9);
+}
+
+// Transferência recusada pelo transporte: nada muda e o quadro sai inteiro
+// no envio seguinte
+static uint8_t shadow_buffer[SSD1306_BUFSIZE(WIDTH, HEIGHT)];
+static uint8_t shadow_before[SSD1306_BUFSIZE(WIDTH, HEIGHT)];
+
+static void test_async_refused(void) {
+  ssd1306_t ssd;
+  display_init(&ssd);
+  ssd1306_set_transport(&ssd, &async_transport, NULL);
+  ssd1306_enable_shadow(&ssd, shadow_buffer);
+  refuse = false;
+  draw_frame(&ssd, 0);
+  CHECK(ssd1306_send_diff_async(&ssd));
+  CHECK(panel_matches(&ssd));
+
+  draw_frame(&ssd, 1);
+  ssd1306_stats_t stats = ssd.stats;
+  uint32_t transactions = bus.transactions;
+  memcpy(shadow_before, shadow_buffer, sizeof(shadow_buffer));
+  refuse = true;
+  CHECK(!ssd1306_send_diff_async(&ssd));
+  CHECK(!ssd1306_send_dirty_async(&ssd));
+  CHECK(!ssd1306_send_data_async(&ssd));
+  CHECK_EQ(bus.transactions, transactions);
+  CHECK(memcmp(&stats, &ssd.stats, sizeof(stats)) == 0);
+  CHECK(memcmp(shadow_before, shadow_buffer, sizeof(shadow_buffer)) == 0);
+  CHECK(ssd.dirty_x0 <= ssd.dirty_x1);
+
+  refuse = false;
+  CHECK(ssd1306_send_diff_async(&ssd));
+  CHECK(panel_matches(&ssd));
+  CHECK_EQ(ssd.stats.frames_sent, stats.frames_sent + 1);
+  CHECK(memcmp(&ssd.ram_buffer[1], &shadow_buffer[1], ssd.bufsize - 1) == 0);
+}
+
+// Transferência aceita que aborta no barramento: o envio seguinte (resend,
+// sem nada novo desenhado) reenvia a região perdida, em cada modo de envio
+typedef bool (*send_async_fn_t)(ssd1306_t *ssd);
+
+static bool send_corner_async(ssd1306_t *ssd) {
+  const ssd1306_area_t corner = { 0, 0, 15, 7 };
+  return ssd1306_send_areas_async(ssd, &corner, 1);
+}
+
+static bool send_no_areas_async(ssd1306_t *ssd) {
+  return ssd1306_send_areas_async(ssd, NULL, 0);
+}
+
+static void check_abort(send_async_fn_t send, send_async_fn_t resend) {
+  ssd1306_t ssd;
+  display_init(&ssd);
+  ssd1306_set_transport(&ssd, &async_transport, NULL);
+  ssd1306_enable_shadow(&ssd, shadow_buffer);
+  refuse = false;
+  abort_after = -1;
+  draw_frame(&ssd, 0);
+  CHECK(ssd1306_send_data_async(&ssd));
+  CHECK(panel_matches(&ssd));
+
+  // Só a primeira transação (a janela) chega ao painel
+  ssd1306_rect(&ssd, 0, 4, 8, 8, true, true);
+  abort_after = 1;
+  CHECK(send(&ssd));
+  CHECK(!panel_matches(&ssd));
+  CHECK_EQ(ssd.stats.transfer_errors, 0);
+
+  abort_after = -1;
+  CHECK(resend(&ssd));
+  CHECK_EQ(ssd.stats.transfer_errors, 1);
+  CHECK(panel_matches(&ssd));
+  CHECK(memcmp(&ssd.ram_buffer[1], &shadow_buffer[1], ssd.bufsize - 1) == 0);
+
+  // Recuperado: a falha é tratada uma vez só
+  CHECK(resend(&ssd));
+  CHECK_EQ(ssd.stats.transfer_errors, 1);
+  CHECK(panel_matches(&ssd));
+}
+
+static void test_async_abort(void) {
+  check_abort(ssd1306_send_diff_async, ssd1306_send_diff_async);
+  check_abort(ssd1306_send_dirty_async, ssd1306_send_dirty_async);
+  check_abort(ssd1306_send_data_async, ssd1306_send_diff_async);
+  check_abort(send_corner_async, send_no_areas_async);
+}
+
+int main(void) {
+  test_batched_commands();
+  test_send_dirty();
+  test_bytes_saved();
+  test_async_refused();
+  test_async_abort();
+  return TEST_RESULT();
+}
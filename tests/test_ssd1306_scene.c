@@ -0,0 +1,285 @@
+#include "ssd1306_scene.h"
+#include "ssd1306_i2c.h"
+#include "ssd1306_emu.h"
+#include "test.h"
+#include <stdio.h>
+#include <string.h>
+
+// Testa a lista de danos da cena retida de inc/ssd1306_scene.c e confere que
+// as atualizações parciais deixam a tela igual a um redesenho completo; os
+// envios vão ao emulador da GDDRAM de sim/, como em test_ssd1306.c
+
+#define WIDTH 128
+#define HEIGHT 64
+
+static uint32_t bus_bytes;
+
+static void mock_write(void *ctx, uint8_t address, const uint8_t *src, size_t len) {
+  ssd1306_emu_write(src, len);
+  bus_bytes += len + 1;
+}
+
+const ssd1306_transport_t ssd1306_i2c_transport = {
+  .write = mock_write,
+};
+
+void *ssd1306_i2c_context(i2c_inst_t *i2c) {
+  return i2c;
+}
+
+void tight_loop_contents(void) {}
+
+static uint8_t ram_buffer[SSD1306_BUFSIZE(WIDTH, HEIGHT)];
+static uint8_t scratch_buffer[SSD1306_SCRATCH_SIZE(WIDTH, HEIGHT)];
+static uint8_t reference[SSD1306_BUFSIZE(WIDTH, HEIGHT)];
+
+static ssd1306_t ssd;
+static ssd1306_scene_t scene;
+
+// Cena vazia; ssd1306_scene_init deixa a tela inteira pendente
+static void start(void) {
+  ssd1306_emu_reset();
+  ssd1306_init(&ssd, WIDTH, HEIGHT, false, 0x3C, NULL, ram_buffer, scratch_buffer);
+  ssd1306_scene_init(&scene, &ssd);
+}
+
+static bool panel_matches(void) {
+  for (uint8_t y = 0; y < HEIGHT; ++y)
+    for (uint8_t x = 0; x < WIDTH; ++x)
+      if (ssd1306_emu_pixel(x, y) != (bool)(ssd.ram_buffer[x * ssd.pages + y / 8 + 1] & (1u << (y % 8))))
+        return false;
+  return true;
+}
+
+static bool area_is(const ssd1306_area_t *a, int x0, int y0, int x1, int y1) {
+  return a->x0 == x0 && a->y0 == y0 && a->x1 == x1 && a->y1 == y1;
+}
+
+// Áreas da lista disjuntas, alinhadas às páginas e dentro da tela
+static bool list_valid(const ssd1306_area_t *list, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    const ssd1306_area_t *a = &list[i];
+    if (a->x0 < 0 || a->y0 < 0 || a->x1 >= WIDTH || a->y1 >= HEIGHT || a->y0 % 8 || a->y1 % 8 != 7)
+      return false;
+    for (size_t j = i + 1; j < count; ++j) {
+      const ssd1306_area_t *b = &list[j];
+      if (a->x0 <= b->x1 && b->x0 <= a->x1 && a->y0 <= b->y1 && b->y0 <= a->y1)
+        return false;
+    }
+  }
+  return true;
+}
+
+static bool list_covers(const ssd1306_area_t *list, size_t count, int x, int y) {
+  for (size_t i = 0; i < count; ++i)
+    if (x >= list[i].x0 && x <= list[i].x1 && y >= list[i].y0 && y <= list[i].y1)
+      return true;
+  return false;
+}
+
+static void test_damage_align(void) {
+  start();
+  scene.pending_count = 0;
+
+  // Alinhada às páginas e recortada pela tela
+  ssd1306_scene_damage(&scene, 3, 5, 10, 9);
+  CHECK_EQ(scene.pending_count, 1);
+  CHECK(area_is(&scene.pending[0], 3, 0, 10, 15));
+
+  ssd1306_scene_damage(&scene, 120, 60, 200, 90);
+  CHECK_EQ(scene.pending_count, 2);
+  CHECK(area_is(&scene.pending[1], 120, 56, 127, 63));
+
+  // Fora da tela ou vazia: nada
+  ssd1306_scene_damage(&scene, -20, 10, -1, 20);
+  ssd1306_scene_damage(&scene, 50, 20, 40, 30);
+  CHECK_EQ(scene.pending_count, 2);
+}
+
+static void test_damage_merge(void) {
+  start();
+  scene.pending_count = 0;
+
+  // Sobreposta na mesma página: une
+  ssd1306_scene_damage(&scene, 10, 0, 20, 7);
+  ssd1306_scene_damage(&scene, 15, 2, 30, 5);
+  CHECK_EQ(scene.pending_count, 1);
+  CHECK(area_is(&scene.pending[0], 10, 0, 30, 7));
+
+  // Encostada: a união não custa bytes a mais
+  ssd1306_scene_damage(&scene, 31, 0, 40, 7);
+  CHECK_EQ(scene.pending_count, 1);
+  CHECK(area_is(&scene.pending[0], 10, 0, 40, 7));
+
+  // Longe: janela própria
+  ssd1306_scene_damage(&scene, 100, 40, 110, 47);
+  CHECK_EQ(scene.pending_count, 2);
+
+  // Perto o bastante para a união custar menos que uma janela a mais
+  ssd1306_scene_damage(&scene, 113, 40, 120, 47);
+  CHECK_EQ(scene.pending_count, 2);
+  CHECK(list_covers(scene.pending, scene.pending_count, 112, 40));
+
+  // Uma área que cruza as três: tudo vira uma
+  ssd1306_scene_damage(&scene, 60, 20, 70, 27);
+  CHECK_EQ(scene.pending_count, 3);
+  ssd1306_scene_damage(&scene, 5, 0, 105, 40);
+  CHECK_EQ(scene.pending_count, 1);
+  CHECK(list_valid(scene.pending, scene.pending_count));
+  CHECK(list_covers(scene.pending, scene.pending_count, 120, 47));
+}
+
+// Mais áreas distantes que janelas: a lista não passa do limite, continua
+// disjunta e cobre todos os pixels danificados
+static void test_damage_full_list(void) {
+  start();
+  scene.pending_count = 0;
+
+  bool covered = true;
+  for (int i = 0; i < 24; ++i) {
+    int x = (i * 37) % 120, y = (i * 23) % 60;
+    ssd1306_scene_damage(&scene, x, y, x + 3, y + 1);
+    CHECK(scene.pending_count <= SSD1306_SCENE_MAX_DAMAGE);
+    for (int k = 0; k <= i; ++k) {
+      int kx = (k * 37) % 120, ky = (k * 23) % 60;
+      covered &= list_covers(scene.pending, scene.pending_count, kx, ky) &&
+                 list_covers(scene.pending, scene.pending_count, kx + 3, ky + 1);
+    }
+  }
+  CHECK_EQ(scene.pending_count, SSD1306_SCENE_MAX_DAMAGE);
+  CHECK(list_valid(scene.pending, scene.pending_count));
+  CHECK(covered);
+}
+
+// Nós alterados danificam a área antiga e a nova, e só elas
+static void test_node_damage(void) {
+  start();
+  ssd1306_node_t label;
+  ssd1306_node_label(&label, 8, 16, "ab");
+  ssd1306_scene_add(&scene, &label);
+  ssd1306_scene_render(&scene);
+  ssd1306_scene_send(&scene);
+
+  // Nada mudou: nada a redesenhar
+  CHECK_EQ(ssd1306_scene_render(&scene), 0);
+
+  ssd1306_node_move(&label, 80, 40);
+  CHECK_EQ(ssd1306_scene_render(&scene), 2);
+  CHECK(list_covers(scene.damage, scene.damage_count, 8, 16));
+  CHECK(list_covers(scene.damage, scene.damage_count, 95, 47));
+  CHECK(!list_covers(scene.damage, scene.damage_count, 40, 30));
+  ssd1306_scene_send(&scene);
+  CHECK(panel_matches());
+
+  // Um caractere diferente: só a célula dele
+  ssd1306_scene_set_label(&scene, &label, "ax");
+  CHECK_EQ(ssd1306_scene_render(&scene), 1);
+  CHECK(area_is(&scene.damage[0], 88, 40, 95, 47));
+  ssd1306_scene_send(&scene);
+
+  ssd1306_node_show(&label, false);
+  CHECK_EQ(ssd1306_scene_render(&scene), 1);
+  ssd1306_scene_send(&scene);
+  CHECK(panel_matches());
+  bool blank = true;
+  for (size_t i = 1; i < ssd.bufsize; ++i)
+    blank &= ssd.ram_buffer[i] == 0;
+  CHECK(blank);
+}
+
+// Sequência com todos os tipos de nó: a cada quadro o painel mostra o
+// framebuffer, e a cada 8 quadros um redesenho completo não muda nada
+static void test_incremental_matches_full(void) {
+  start();
+  ssd1306_node_t border, title, counter, bar, vbar, plot, cursor;
+  // Duas amostras por coluna: o gráfico desenha o envelope
+  strip_chart_t chart;
+  strip_chart_init(&chart, 47, 39, 0, 255, 2);
+  ssd1306_node_border(&border, 0, 0, WIDTH, HEIGHT, SSD1306_BORDER_SOLID);
+  ssd1306_node_label(&title, 4, 4, "cena");
+  ssd1306_node_label(&counter, 80, 4, "000");
+  ssd1306_node_bar(&bar, 4, 16, 60, 8, 100, false);
+  ssd1306_node_bar(&vbar, 116, 16, 8, 40, 100, true);
+  ssd1306_node_plot(&plot, 64, 20, &chart);
+  ssd1306_node_label(&cursor, 8, 40, "*");
+  ssd1306_node_t *nodes[] = { &border, &title, &counter, &bar, &vbar, &plot, &cursor };
+  for (size_t i = 0; i < count_of(nodes); ++i)
+    CHECK(ssd1306_scene_add(&scene, nodes[i]));
+
+  bool matches = true, same = true;
+  uint32_t full_bytes = 0;
+  for (int i = 0; i < 64; ++i) {
+    char text[8];
+    snprintf(text, sizeof(text), "%03d", i * 7);
+    ssd1306_scene_set_label(&scene, &counter, text);
+    ssd1306_scene_set_bar(&scene, &bar, (uint16_t)((i * 13) % 101));
+    ssd1306_scene_set_bar(&scene, &vbar, (uint16_t)(100 - (i * 7) % 101));
+    ssd1306_scene_plot_push(&scene, &plot, (uint16_t)((i * 29) % 256));
+    // Amostra acrescentada fora da cena: danificada no render
+    strip_chart_push(&chart, (uint16_t)((i * 53) % 256));
+    ssd1306_node_move(&cursor, 8 + (i * 5) % 48, 32 + (i % 3) * 8);
+    if (i % 16 == 8)
+      ssd1306_node_set_border(&border, (ssd1306_border_style_t)((i / 16) % 3));
+    ssd1306_node_show(&title, i % 20 < 15);
+
+    bus_bytes = 0;
+    ssd1306_scene_render(&scene);
+    CHECK(list_valid(scene.damage, scene.damage_count));
+    ssd1306_scene_send(&scene);
+    // Fora o primeiro quadro e as trocas da borda, que cobre a tela toda,
+    // os envios são parciais
+    if (i == 0)
+      full_bytes = bus_bytes;
+    else if (i % 16 != 8)
+      CHECK(bus_bytes < full_bytes);
+    matches &= panel_matches();
+
+    if (i % 8 == 7) {
+      memcpy(reference, ram_buffer, sizeof(reference));
+      ssd1306_scene_damage(&scene, 0, 0, WIDTH - 1, HEIGHT - 1);
+      ssd1306_scene_render(&scene);
+      same &= memcmp(reference, ram_buffer, sizeof(reference)) == 0;
+      ssd1306_scene_send(&scene);
+    }
+  }
+  CHECK(matches);
+  CHECK(same);
+
+  // A área interna do nó é exatamente o que o próprio gráfico desenha
+  memcpy(reference, ram_buffer, sizeof(reference));
+  ssd1306_view_t inner;
+  ssd1306_view_init(&inner, &ssd, 65, 20, chart.width, chart.height);
+  strip_chart_redraw(&chart, &inner);
+  CHECK(memcmp(reference, ram_buffer, sizeof(reference)) == 0);
+}
+
+// Desenho incremental do gráfico depois de o anel dar voltas, com uma ou
+// várias colunas novas por chamada: igual ao redesenho completo
+static void test_strip_chart_wraps(void) {
+  start();
+  strip_chart_t chart;
+  strip_chart_init(&chart, 20, 16, 0, 255, 1);
+  ssd1306_view_t view;
+  ssd1306_view_init(&view, &ssd, 10, 8, chart.width, chart.height);
+
+  bool same = true;
+  for (int i = 0; i < 150; ++i) {
+    for (int n = 0; n <= i % 3; ++n)
+      strip_chart_push(&chart, (uint16_t)((i * 71 + n * 33) % 256));
+    strip_chart_draw(&chart, &view);
+    memcpy(reference, ram_buffer, sizeof(reference));
+    strip_chart_redraw(&chart, &view);
+    same &= memcmp(reference, ram_buffer, sizeof(reference)) == 0;
+  }
+  CHECK(same);
+}
+
+int main(void) {
+  test_damage_align();
+  test_damage_merge();
+  test_damage_full_list();
+  test_node_damage();
+  test_incremental_matches_full();
+  test_strip_chart_wraps();
+  return TEST_RESULT();
+}
@@ -0,0 +1,271 @@
+#include "stream.h"
+#include "test.h"
+#include <string.h>
+
+// Testa o formato dos quadros de inc/stream.c e a entrega em pedaços; o
+// leitor abaixo aplica as mesmas regras de tools/stream_read.py (sincronia
+// pelo magic, versão, CRC e saltos na sequência) para fechar a volta
+
+#define RATE_HZ 2000
+
+static uint16_t get_u16(const uint8_t *p) {
+  return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t *p) {
+  return get_u16(p) | (uint32_t)get_u16(p + 2) << 16;
+}
+
+// Amostra i da sequência de teste, 12 bits em cada eixo
+static uint16_t sample_x(uint32_t i) {
+  return (uint16_t)((i * 2654435761u) >> 20);
+}
+
+static uint16_t sample_y(uint32_t i) {
+  return (uint16_t)(4095 - (i * 37) % 4096);
+}
+
+// Perdas do ADC informadas antes do quadro n
+static uint16_t lost_for(uint32_t n) {
+  return (uint16_t)(n % 5);
+}
+
+// Empurra um quadro inteiro a partir da amostra first
+static void push_frame(stream_t *s, uint32_t first) {
+  for (uint32_t i = first; i < first + STREAM_SAMPLES; ++i)
+    stream_push(s, sample_x(i), sample_y(i), 1000 + i * (1000000 / RATE_HZ));
+}
+
+static void test_crc(void) {
+  CHECK_EQ(stream_crc16((const uint8_t *)"123456789", 9), 0x29B1);
+  CHECK_EQ(stream_crc16(NULL, 0), 0xFFFF);
+}
+
+static void test_frame_layout(void) {
+  static stream_t s;
+  stream_init(&s, RATE_HZ);
+  // Parado, nada é montado
+  stream_push(&s, 1, 2, 3);
+  CHECK_EQ(s.count, 0);
+
+  stream_start(&s);
+  stream_note_lost(&s, 7);
+  stream_push(&s, 0xABC, 0x123, 5000);
+  stream_push(&s, 0x001, 0xFFF, 5500);
+  stream_note_lost(&s, 3);  // vai para o quadro seguinte
+  for (int i = 2; i < STREAM_SAMPLES; ++i)
+    stream_push(&s, 0, 0, 5000 + i * 500);
+
+  uint8_t f[STREAM_FRAME_BYTES];
+  CHECK_EQ(stream_take(&s, f, sizeof(f)), STREAM_FRAME_BYTES);
+  CHECK_EQ(STREAM_FRAME_BYTES, 114);
+  CHECK(f[0] == 0xA5 && f[1] == 0x5A);
+  CHECK_EQ(f[2], STREAM_VERSION);
+  CHECK_EQ(f[3], STREAM_SAMPLES);
+  CHECK_EQ(get_u32(&f[4]), 0);
+  CHECK_EQ(get_u32(&f[8]), 5000);
+  CHECK_EQ(get_u16(&f[12]), 500);
+  CHECK_EQ(get_u16(&f[14]), 7);
+  // x[7:0], x[11:8] | y[3:0] << 4, y[11:4]
+  const uint8_t *p = &f[STREAM_HEADER_BYTES];
+  CHECK(p[0] == 0xBC && p[1] == 0x3A && p[2] == 0x12);
+  CHECK(p[3] == 0x01 && p[4] == 0xF0 && p[5] == 0xFF);
+  CHECK_EQ(get_u16(&f[STREAM_FRAME_BYTES - 2]), stream_crc16(f, STREAM_FRAME_BYTES - 2));
+
+  push_frame(&s, 0);
+  CHECK_EQ(stream_take(&s, f, sizeof(f)), STREAM_FRAME_BYTES);
+  CHECK_EQ(get_u32(&f[4]), 1);
+  CHECK_EQ(get_u16(&f[14]), 3);
+
+  // Perdas acima de 16 bits saturam
+  stream_note_lost(&s, 70000);
+  push_frame(&s, 0);
+  CHECK_EQ(stream_take(&s, f, sizeof(f)), STREAM_FRAME_BYTES);
+  CHECK_EQ(get_u16(&f[14]), 0xFFFF);
+}
+
+// Fila cheia: os quadros excedentes são descartados, mas consomem números de
+// sequência, e o leitor vê o salto
+static void test_dropped_sequence(void) {
+  static stream_t s;
+  stream_init(&s, RATE_HZ);
+  stream_start(&s);
+  for (uint32_t n = 0; n < STREAM_QUEUE_FRAMES + 2; ++n)
+    push_frame(&s, n * STREAM_SAMPLES);
+  CHECK_EQ(s.dropped, 2);
+
+  uint8_t f[STREAM_FRAME_BYTES];
+  for (uint32_t n = 0; n < STREAM_QUEUE_FRAMES; ++n) {
+    CHECK_EQ(stream_take(&s, f, sizeof(f)), STREAM_FRAME_BYTES);
+    CHECK_EQ(get_u32(&f[4]), n);
+  }
+  CHECK_EQ(stream_take(&s, f, sizeof(f)), 0);
+  push_frame(&s, 0);
+  CHECK_EQ(stream_take(&s, f, sizeof(f)), STREAM_FRAME_BYTES);
+  CHECK_EQ(get_u32(&f[4]), STREAM_QUEUE_FRAMES + 2);
+}
+
+// Pedaços menores que um quadro: a concatenação é igual à entrega inteira, e
+// parar descarta o que ficou pela metade
+static void test_take_split(void) {
+  static stream_t a, b;
+  stream_init(&a, RATE_HZ);
+  stream_init(&b, RATE_HZ);
+  stream_start(&a);
+  stream_start(&b);
+  for (uint32_t n = 0; n < 3; ++n) {
+    push_frame(&a, n * STREAM_SAMPLES);
+    push_frame(&b, n * STREAM_SAMPLES);
+  }
+
+  uint8_t whole[3 * STREAM_FRAME_BYTES], pieces[3 * STREAM_FRAME_BYTES];
+  CHECK_EQ(stream_take(&a, whole, sizeof(whole)), sizeof(whole));
+  size_t len = 0, n;
+  while ((n = stream_take(&b, &pieces[len], 7)) > 0) {
+    CHECK(n <= 7);
+    len += n;
+  }
+  CHECK_EQ(len, sizeof(pieces));
+  CHECK(memcmp(whole, pieces, sizeof(whole)) == 0);
+
+  push_frame(&b, 0);
+  CHECK_EQ(stream_take(&b, pieces, 50), 50);
+  CHECK_EQ(b.offset, 50);
+  stream_stop(&b);
+  CHECK_EQ(stream_take(&b, pieces, sizeof(pieces)), 0);
+  // Recomeça em um quadro inteiro
+  stream_start(&b);
+  push_frame(&b, 0);
+  CHECK_EQ(stream_take(&b, pieces, sizeof(pieces)), STREAM_FRAME_BYTES);
+  CHECK(pieces[0] == 0xA5 && pieces[1] == 0x5A);
+}
+
+// Leitor com as regras de Parser.feed/accept de tools/stream_read.py
+typedef struct {
+  uint8_t buf[1024];
+  size_t len;
+  uint32_t frames, samples, dropped, bad_crc, skipped;
+  bool have_seq;
+  uint32_t last_seq;
+  uint32_t mismatches;   // amostras ou perdas diferentes das esperadas
+} reader_t;
+
+static void reader_drop(reader_t *r, size_t n) {
+  memmove(r->buf, &r->buf[n], r->len - n);
+  r->len -= n;
+}
+
+static void reader_accept(reader_t *r, const uint8_t *frame, uint8_t samples) {
+  uint32_t seq = get_u32(&frame[4]);
+  if (r->have_seq)
+    r->dropped += seq - r->last_seq - 1;
+  r->have_seq = true;
+  r->last_seq = seq;
+  r->frames++;
+  if (get_u16(&frame[14]) != lost_for(seq))
+    r->mismatches++;
+  // O quadro de número seq leva as amostras seq * STREAM_SAMPLES em diante
+  for (uint32_t i = 0; i < samples; ++i) {
+    const uint8_t *p = &frame[STREAM_HEADER_BYTES + 3 * i];
+    uint16_t x = p[0] | (p[1] & 0x0F) << 8;
+    uint16_t y = p[1] >> 4 | p[2] << 4;
+    uint32_t k = seq * STREAM_SAMPLES + i;
+    if (x != sample_x(k) || y != sample_y(k))
+      r->mismatches++;
+    r->samples++;
+  }
+}
+
+static void reader_feed(reader_t *r, const uint8_t *data, size_t n) {
+  memcpy(&r->buf[r->len], data, n);
+  r->len += n;
+  for (;;) {
+    size_t pos = 0;
+    while (pos + 1 < r->len && !(r->buf[pos] == 0xA5 && r->buf[pos + 1] == 0x5A))
+      ++pos;
+    if (pos + 1 >= r->len) {
+      // Sem magic: guarda só um possível primeiro byte dele
+      size_t keep = r->len && r->buf[r->len - 1] == 0xA5 ? 1 : 0;
+      r->skipped += r->len - keep;
+      reader_drop(r, r->len - keep);
+      return;
+    }
+    r->skipped += pos;
+    reader_drop(r, pos);
+    if (r->len < STREAM_HEADER_BYTES)
+      return;
+    uint8_t samples = r->buf[3];
+    size_t size = STREAM_HEADER_BYTES + samples * 3 + 2;
+    if (r->buf[2] != STREAM_VERSION || samples == 0) {
+      r->skipped++;
+      reader_drop(r, 1);
+      continue;
+    }
+    if (r->len < size)
+      return;
+    if (get_u16(&r->buf[size - 2]) != stream_crc16(r->buf, size - 2)) {
+      r->bad_crc++;
+      reader_drop(r, 1);
+      continue;
+    }
+    reader_accept(r, r->buf, samples);
+    reader_drop(r, size);
+  }
+}
+
+// Quadros entregues em pedaços de tamanhos variados, com texto do printf
+// entre eles, um quadro corrompido e quadros descartados pela fila cheia
+#define CORRUPT_AT (5 * STREAM_FRAME_BYTES + 40)
+
+static void test_round_trip(void) {
+  static stream_t s;
+  static reader_t r;
+  stream_init(&s, RATE_HZ);
+  stream_start(&s);
+
+  static const char text[] = "sched: sample periodo 1000 us\n\xA5 texto\n";
+  reader_feed(&r, (const uint8_t *)text, sizeof(text) - 1);
+
+  uint32_t frame = 0, texts = 0;
+  size_t offset = 0;
+  uint8_t chunk[64];
+  for (int round = 0; round < 42; ++round) {
+    // A cada 10 rodadas a fila enche e perde 2 quadros
+    int burst = round % 10 == 9 ? STREAM_QUEUE_FRAMES + 2 : 1 + round % 3;
+    for (int i = 0; i < burst; ++i, ++frame) {
+      stream_note_lost(&s, lost_for(frame));
+      push_frame(&s, frame * STREAM_SAMPLES);
+    }
+    size_t max = 1 + (size_t)(round * 13) % sizeof(chunk), n;
+    while ((n = stream_take(&s, chunk, max)) > 0) {
+      if (offset <= CORRUPT_AT && CORRUPT_AT < offset + n)
+        chunk[CORRUPT_AT - offset] ^= 0x40;
+      offset += n;
+      reader_feed(&r, chunk, n);
+      // Texto só entre quadros, como o do firmware antes de ligar o streaming
+      if (round % 7 == 3 && offset % STREAM_FRAME_BYTES == 0) {
+        reader_feed(&r, (const uint8_t *)"ok\n", 3);
+        texts++;
+      }
+    }
+  }
+
+  CHECK_EQ(r.mismatches, 0);
+  CHECK_EQ(r.bad_crc, 1);
+  CHECK_EQ(s.dropped, 8);
+  // O quadro corrompido aparece ao leitor como mais um salto na sequência
+  CHECK_EQ(r.dropped, s.dropped + 1);
+  CHECK_EQ(r.frames + r.dropped, frame);
+  CHECK_EQ(r.samples, r.frames * STREAM_SAMPLES);
+  CHECK(texts > 0);
+  CHECK(r.skipped >= sizeof(text) - 1 + 3 * texts);
+}
+
+int main(void) {
+  test_crc();
+  test_frame_layout();
+  test_dropped_sequence();
+  test_take_split();
+  test_round_trip();
+  return TEST_RESULT();
+}
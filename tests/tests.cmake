@@ -0,0 +1,90 @@
+# Testes de unidade no host (ctest), configurados junto com a simulação:
+#   cmake -S . -B build -DBITDOGLAB_HOST_SIM=ON && cmake --build build && ctest --test-dir build
+# Cada teste é um executável que retorna 0 se todas as verificações passarem.
+enable_testing()
+
+# Leitor do anel do DMA do amostrador real, sobre o DMA falso de tests/hal
+add_executable(test-adc-sampler tests/test_adc_sampler.c inc/adc_sampler.c)
+target_include_directories(test-adc-sampler PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc)
+add_test(NAME adc_sampler COMMAND test-adc-sampler)
+
+# Envios do driver do display conferidos no emulador da GDDRAM
+add_executable(test-ssd1306 tests/test_ssd1306.c inc/ssd1306.c sim/ssd1306_emu.c ${GENERATED_DIR}/font_ascii.h)
+target_include_directories(test-ssd1306 PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc
+        ${GENERATED_DIR})
+add_test(NAME ssd1306 COMMAND test-ssd1306)
+
+# Filtro dos eixos com os roteiros de ruído de tests/traces; usa a zona morta
+# padrão do cabeçalho, para a qual o roteiro da borda foi gravado
+add_executable(test-joystick-filter tests/test_joystick_filter.c inc/joystick_filter.c)
+target_include_directories(test-joystick-filter PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc)
+add_test(NAME joystick_filter COMMAND test-joystick-filter ${CMAKE_CURRENT_SOURCE_DIR}/tests/traces)
+
+# Mapeamento e perfil de calibração, sobre a flash emulada de sim/
+add_executable(test-joystick-cal tests/test_joystick_cal.c inc/joystick_cal.c inc/joystick_filter.c
+        sim/sim_hal.c sim/ssd1306_emu.c ${GENERATED_DIR}/joystick_lut.h)
+target_include_directories(test-joystick-cal PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc
+        ${GENERATED_DIR})
+add_test(NAME joystick_cal COMMAND test-joystick-cal)
+
+# Prazos, descartes e adaptação do escalonador com um relógio virtual
+add_executable(test-scheduler tests/test_scheduler.c inc/scheduler.c)
+target_include_directories(test-scheduler PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc)
+add_test(NAME scheduler COMMAND test-scheduler)
+# Sem os descartes a carga acima da CPU prende sched_run
+set_tests_properties(scheduler PROPERTIES TIMEOUT 10)
+
+# Fila de bordas, debounce e gestos dos botões, e a fila SPSC com duas threads
+find_package(Threads REQUIRED)
+add_executable(test-button tests/test_button.c inc/button.c inc/spsc_queue.c)
+target_include_directories(test-button PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc)
+target_link_libraries(test-button PRIVATE Threads::Threads)
+add_test(NAME button COMMAND test-button)
+
+# Lista de danos da cena retida e atualizações parciais contra o redesenho completo
+add_executable(test-ssd1306-scene tests/test_ssd1306_scene.c inc/ssd1306.c inc/ssd1306_blit.c inc/ssd1306_scene.c
+        inc/strip_chart.c sim/ssd1306_emu.c ${GENERATED_DIR}/font_ascii.h)
+target_include_directories(test-ssd1306-scene PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc
+        ${GENERATED_DIR})
+add_test(NAME ssd1306_scene COMMAND test-ssd1306-scene)
+
+# Curvas, conclusão e troca de alvo dos fades dos LEDs sobre o transporte da
+# simulação (um alarme por wrap do PWM)
+add_executable(test-led-fade tests/test_led_fade.c inc/led_fade.c sim/led_fade_sim.c)
+target_include_directories(test-led-fade PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim/hal
+        ${CMAKE_CURRENT_SOURCE_DIR}/sim
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc)
+add_test(NAME led_fade COMMAND test-led-fade)
+
+# Formato dos quadros do streaming e a volta pelas regras de tools/stream_read.py
+add_executable(test-stream tests/test_stream.c inc/stream.c)
+target_include_directories(test-stream PRIVATE
+        ${CMAKE_CURRENT_SOURCE_DIR}/tests
+        ${CMAKE_CURRENT_SOURCE_DIR}/inc)
+add_test(NAME stream COMMAND test-stream)
@@ -0,0 +1,77 @@
+#!/usr/bin/env python3
+"""Gera font_ascii.h a partir de inc/font.h.
+
+A tabela gerada tem uma entrada de 8 bytes por caractere ASCII imprimível
+(' ' a '~'), indexada diretamente por (c - ' '). Caracteres sem glifo na
+fonte ficam em branco.
+
+Uso: gen_font_table.py <font.h> <saida.h>
+"""
+import re
+import sys
+
+
+def parse_font(path):
+    text = open(path, encoding="utf-8").read()
+
+    offsets = {m.group(1): int(m.group(2))
+               for m in re.finditer(r"#define\s+FONT_OFFSET_(\w+)\s+(\d+)", text)}
+
+    symbols = re.search(r'#define\s+FONT_SYMBOLS\s+"((?:[^"\\]|\\.)*)"', text).group(1)
+    symbols = re.sub(r"\\(.)", r"\1", symbols)
+
+    body = re.search(r"font\[\]\s*=\s*\{(.*?)\};", text, re.S).group(1)
+    body = re.sub(r"//[^\n]*", "", body)
+    data = [int(v, 16) for v in re.findall(r"0x[0-9A-Fa-f]{2}", body)]
+    glyphs = [data[i:i + 8] for i in range(0, len(data), 8)]
+
+    return offsets, symbols, glyphs
+
+
+def build_table(offsets, symbols, glyphs):
+    index = {" ": offsets["SPACE"]}
+    for i in range(10):
+        index[chr(ord("0") + i)] = offsets["NUMBERS"] + i
+    for i in range(26):
+        index[chr(ord("A") + i)] = offsets["UPPERCASE"] + i
+        index[chr(ord("a") + i)] = offsets["LOWERCASE"] + i
+    for i, c in enumerate(symbols):
+        index[c] = offsets["SYMBOLS"] + i
+
+    table = []
+    for code in range(0x20, 0x7F):
+        c = chr(code)
+        glyph = glyphs[index[c]] if c in index and index[c] < len(glyphs) else [0] * 8
+        table.append((c, glyph))
+    return table
+
+
+def main():
+    if len(sys.argv) != 3:
+        sys.exit(__doc__)
+
+    table = build_table(*parse_font(sys.argv[1]))
+
+    out = [
+        "// Gerado por tools/gen_font_table.py a partir de inc/font.h; não editar",
+        "#ifndef FONT_ASCII_H",
+        "#define FONT_ASCII_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define FONT_ASCII_FIRST ' '",
+        "#define FONT_ASCII_LAST '~'",
+        "",
+        "// Glifos 8x8 indexados por (c - FONT_ASCII_FIRST); cada byte é uma coluna",
+        "static const uint8_t font_ascii[%d][8] = {" % len(table),
+    ]
+    for c, glyph in table:
+        out.append("  {%s}, // 0x%02X" % (", ".join("0x%02X" % b for b in glyph), ord(c)))
+    out += ["};", "", "#endif // FONT_ASCII_H", ""]
+
+    with open(sys.argv[2], "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,57 @@
+#!/usr/bin/env python3
+"""Gera joystick_lut.h com a curva de brilho dos LEDs.
+
+  lut_gamma[m]   magnitude linear (0-4095) -> nível PWM com correção de gama
+
+Centro, zona morta e fins de curso vêm do perfil de calibração
+(inc/joystick_cal.c), que o firmware converte em coeficientes na
+inicialização; só a gama, que não depende do joystick, é tabelada aqui.
+"""
+import argparse
+
+ADC_MAX = 4095
+PWM_MAX = 4095
+
+
+def gamma_curve(gamma):
+    return [round(PWM_MAX * (m / PWM_MAX) ** gamma) for m in range(PWM_MAX + 1)]
+
+
+def emit(out, ctype, name, values, per_line=16):
+    out.append("static const %s %s[%d] = {" % (ctype, name, len(values)))
+    for i in range(0, len(values), per_line):
+        out.append("  " + ", ".join(str(v) for v in values[i:i + per_line]) + ",")
+    out.append("};")
+    out.append("")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__,
+                                 formatter_class=argparse.RawDescriptionHelpFormatter)
+    ap.add_argument("--out", required=True)
+    ap.add_argument("--gamma", type=float, default=2.2)
+    args = ap.parse_args()
+
+    gamma_lut = gamma_curve(args.gamma)
+
+    out = [
+        "// Gerado por tools/gen_joystick_lut.py; não editar",
+        "// gama=%g" % args.gamma,
+        "#ifndef JOYSTICK_LUT_H",
+        "#define JOYSTICK_LUT_H",
+        "",
+        "#include <stdint.h>",
+        "",
+        "#define JOYSTICK_LUT_SIZE %d" % (ADC_MAX + 1),
+        "",
+    ]
+    emit(out, "uint16_t", "lut_gamma", gamma_lut)
+    out.append("#endif // JOYSTICK_LUT_H")
+    out.append("")
+
+    with open(args.out, "w", encoding="utf-8") as f:
+        f.write("\n".join(out))
+
+
+if __name__ == "__main__":
+    main()
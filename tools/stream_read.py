@@ -0,0 +1,165 @@
+#!/usr/bin/env python3
+"""Lê o streaming binário de amostras X/Y (inc/stream.h) e relata perdas e vazão.
+
+A entrada é a serial USB da placa (ex.: /dev/ttyACM0, após `stty -F
+/dev/ttyACM0 raw`) ou uma captura salva; '-' lê do stdin. O streaming é
+ligado com um duplo clique no botão A. Texto comum na serial (printf do
+firmware) é ignorado: o leitor se sincroniza pelo magic e confere o CRC de
+cada quadro.
+
+O relatório traz quadros válidos, quadros perdidos (saltos na sequência),
+amostras perdidas pelo ADC, quadros com CRC inválido e a vazão em amostras
+por segundo, medida pelo relógio da placa e pelo do host. Com --csv as
+amostras são gravadas como t_us,x,y.
+"""
+import argparse
+import struct
+import sys
+import time
+
+MAGIC = b"\xa5\x5a"
+VERSION = 1
+HEADER = struct.Struct("<2sBBIIHH")
+
+
+def crc16(data):
+    """CRC-16/CCITT-FALSE, o mesmo de stream_crc16."""
+    crc = 0xFFFF
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else crc << 1
+            crc &= 0xFFFF
+    return crc
+
+
+def frame_size(samples):
+    return HEADER.size + samples * 3 + 2
+
+
+def unpack_samples(payload):
+    for i in range(0, len(payload), 3):
+        b0, b1, b2 = payload[i:i + 3]
+        yield b0 | (b1 & 0x0F) << 8, b1 >> 4 | b2 << 4
+
+
+class Stats:
+    def __init__(self):
+        self.frames = 0
+        self.samples = 0
+        self.dropped = 0
+        self.lost = 0
+        self.bad_crc = 0
+        self.skipped = 0
+        self.last_seq = None
+        self.first_t = None
+        self.last_t = None
+        self.host_start = time.monotonic()
+
+    def report(self):
+        dev_s = ((self.last_t - self.first_t) & 0xFFFFFFFF) / 1e6 if self.frames > 1 else 0
+        host_s = time.monotonic() - self.host_start
+        total = self.frames + self.dropped
+        lines = [
+            f"quadros: {self.frames} válidos, {self.dropped} perdidos"
+            + (f" ({100 * self.dropped / total:.2f}%)" if total else ""),
+            f"amostras: {self.samples} recebidas, {self.lost} perdidas pelo ADC",
+            f"CRC inválido: {self.bad_crc}, bytes fora de quadro: {self.skipped}",
+        ]
+        if dev_s > 0:
+            lines.append(f"vazão (relógio da placa): {self.samples / dev_s:.0f} amostras/s")
+        if host_s > 0:
+            lines.append(f"vazão (relógio do host): {self.samples / host_s:.0f} amostras/s")
+        return "\n".join(lines)
+
+
+class Parser:
+    def __init__(self, stats, csv=None):
+        self.buf = bytearray()
+        self.stats = stats
+        self.csv = csv
+
+    def feed(self, data):
+        self.buf += data
+        while True:
+            pos = self.buf.find(MAGIC)
+            if pos < 0:
+                keep = 1 if self.buf.endswith(MAGIC[:1]) else 0
+                self.stats.skipped += len(self.buf) - keep
+                del self.buf[:len(self.buf) - keep]
+                return
+            if pos:
+                self.stats.skipped += pos
+                del self.buf[:pos]
+            if len(self.buf) < HEADER.size:
+                return
+            _, version, samples, seq, t0, period, lost = HEADER.unpack_from(self.buf)
+            size = frame_size(samples)
+            if version != VERSION or samples == 0:
+                self.stats.skipped += 1
+                del self.buf[:1]
+                continue
+            if len(self.buf) < size:
+                return
+            frame = bytes(self.buf[:size])
+            (crc,) = struct.unpack_from("<H", frame, size - 2)
+            if crc != crc16(frame[:-2]):
+                # Falso magic dentro de texto ou quadro corrompido
+                self.stats.bad_crc += 1
+                del self.buf[:1]
+                continue
+            del self.buf[:size]
+            self.accept(seq, t0, period, lost, frame[HEADER.size:-2])
+
+    def accept(self, seq, t0, period, lost, payload):
+        s = self.stats
+        if s.last_seq is not None:
+            s.dropped += (seq - s.last_seq - 1) & 0xFFFFFFFF
+        s.last_seq = seq
+        if s.first_t is None:
+            s.first_t = t0
+        s.last_t = t0
+        s.frames += 1
+        s.lost += lost
+        for i, (x, y) in enumerate(unpack_samples(payload)):
+            s.samples += 1
+            if self.csv:
+                self.csv.write(f"{(t0 + i * period) & 0xFFFFFFFF},{x},{y}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("source", help="serial, captura ou '-' para stdin")
+    parser.add_argument("--csv", help="grava as amostras (t_us,x,y) neste arquivo")
+    parser.add_argument("--interval", type=float, default=2.0,
+                        help="segundos entre relatórios parciais (0 desliga)")
+    args = parser.parse_args()
+
+    csv = open(args.csv, "w") if args.csv else None
+    if csv:
+        csv.write("t_us,x,y\n")
+    stats = Stats()
+    p = Parser(stats, csv)
+
+    src = sys.stdin.buffer if args.source == "-" else open(args.source, "rb", buffering=0)
+    last_report = time.monotonic()
+    try:
+        while True:
+            data = src.read(4096)
+            if not data:
+                break
+            p.feed(data)
+            now = time.monotonic()
+            if args.interval and now - last_report >= args.interval:
+                print(stats.report(), end="\n\n", flush=True)
+                last_report = now
+    except KeyboardInterrupt:
+        pass
+    finally:
+        if csv:
+            csv.close()
+    print(stats.report())
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,184 @@
+#!/usr/bin/env python3
+"""Decodifica o dump de instrumentação (inc/trace.h) em um relatório por estágio.
+
+A entrada é a captura bruta da serial USB (ex.: `cat /dev/ttyACM0 > captura.bin`
+enquanto se mantém o botão A pressionado por 1 s). Texto comum ao redor do dump
+é ignorado; o último dump válido da captura é usado.
+
+Para cada núcleo e estágio o relatório traz contagem, mínimo, média e máximo
+acumulados desde o boot, percentis estimados pelo histograma log2 e, a partir
+dos eventos recentes do anel, percentis exatos e o período entre execuções.
+"""
+import argparse
+import json
+import struct
+import sys
+
+MAGIC = b"BDTR"
+VERSION = 1
+STAGES = ["adc", "pwm", "raster", "flush", "i2c_bus", "sleep"]
+
+
+class DumpError(Exception):
+    pass
+
+
+class Reader:
+    def __init__(self, data, pos):
+        self.data = data
+        self.pos = pos
+
+    def take(self, fmt):
+        size = struct.calcsize(fmt)
+        if self.pos + size > len(self.data):
+            raise DumpError("dump truncado")
+        values = struct.unpack_from(fmt, self.data, self.pos)
+        self.pos += size
+        return values
+
+
+def parse_dump(data, start):
+    r = Reader(data, start + len(MAGIC))
+    version, cores, stages, buckets, ring, now_us = r.take("<BBBBHI")
+    if version != VERSION:
+        raise DumpError(f"versão {version} não suportada")
+
+    hist = []
+    for _ in range(cores):
+        per_core = []
+        for _ in range(stages):
+            count, min_us, max_us, sum_us = r.take("<IIIQ")
+            per_core.append({
+                "count": count, "min_us": min_us, "max_us": max_us, "sum_us": sum_us,
+                "buckets": list(r.take(f"<{buckets}I")),
+            })
+        hist.append(per_core)
+
+    events = []
+    for core in range(cores):
+        (head,) = r.take("<I")
+        for _ in range(min(head, ring)):
+            start_us, duration_us, stage, ev_core = r.take("<IHBB")
+            events.append({"core": ev_core, "stage": stage, "start_us": start_us,
+                           "duration_us": duration_us})
+
+    expected = sum(data[start:r.pos]) & 0xFFFFFFFF
+    (checksum,) = r.take("<I")
+    if checksum != expected:
+        raise DumpError("soma de verificação não confere")
+    return {"now_us": now_us, "hist": hist, "events": events}
+
+
+def find_dump(data):
+    pos = data.rfind(MAGIC)
+    if pos < 0:
+        raise DumpError("nenhum dump encontrado")
+    while True:
+        try:
+            return parse_dump(data, pos)
+        except DumpError as err:
+            pos = data.rfind(MAGIC, 0, pos)
+            if pos < 0:
+                raise DumpError(f"nenhum dump válido encontrado ({err})")
+
+
+def bucket_percentile(buckets, q):
+    """Limite superior (µs) do bucket que contém o percentil q."""
+    total = sum(buckets)
+    if not total:
+        return None
+    target = q * total
+    acc = 0
+    for b, n in enumerate(buckets):
+        acc += n
+        if acc >= target:
+            return 0 if b == 0 else (1 << b) - 1
+    return (1 << (len(buckets) - 1)) - 1
+
+
+def exact_percentile(values, q):
+    if not values:
+        return None
+    values = sorted(values)
+    return values[min(int(q * len(values)), len(values) - 1)]
+
+
+def stage_name(index):
+    return STAGES[index] if index < len(STAGES) else f"stage{index}"
+
+
+def report(dump):
+    rows = []
+    for core, per_core in enumerate(dump["hist"]):
+        for stage, h in enumerate(per_core):
+            if not h["count"]:
+                continue
+            recent = [e for e in dump["events"] if e["core"] == core and e["stage"] == stage]
+            durations = [e["duration_us"] for e in recent]
+            starts = [e["start_us"] for e in recent]
+            periods = [(b - a) & 0xFFFFFFFF for a, b in zip(starts, starts[1:])]
+            rows.append({
+                "core": core,
+                "stage": stage_name(stage),
+                "count": h["count"],
+                "min_us": h["min_us"],
+                "avg_us": h["sum_us"] / h["count"],
+                "max_us": h["max_us"],
+                "p50_le_us": bucket_percentile(h["buckets"], 0.50),
+                "p99_le_us": bucket_percentile(h["buckets"], 0.99),
+                "recent": len(recent),
+                "recent_p50_us": exact_percentile(durations, 0.50),
+                "recent_p99_us": exact_percentile(durations, 0.99),
+                "recent_period_us": sum(periods) / len(periods) if periods else None,
+            })
+    return rows
+
+
+def fmt(value):
+    if value is None:
+        return "-"
+    if isinstance(value, float):
+        return f"{value:.1f}"
+    return str(value)
+
+
+def print_table(dump, rows):
+    print(f"dump em t={dump['now_us'] / 1e6:.3f} s, {len(dump['events'])} eventos recentes")
+    header = ["núcleo", "estágio", "n", "min", "média", "max", "p50<=", "p99<=",
+              "recentes", "p50", "p99", "período"]
+    keys = ["core", "stage", "count", "min_us", "avg_us", "max_us", "p50_le_us", "p99_le_us",
+            "recent", "recent_p50_us", "recent_p99_us", "recent_period_us"]
+    table = [header] + [[fmt(row[k]) for k in keys] for row in rows]
+    widths = [max(len(line[i]) for line in table) for i in range(len(header))]
+    for line in table:
+        print("  ".join(cell.rjust(w) for cell, w in zip(line, widths)))
+    print("tempos em µs; p50<=/p99<= são limites do histograma log2 desde o boot")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("capture", help="captura bruta da serial ('-' para stdin)")
+    parser.add_argument("--json", action="store_true", help="saída em JSON")
+    args = parser.parse_args()
+
+    if args.capture == "-":
+        data = sys.stdin.buffer.read()
+    else:
+        with open(args.capture, "rb") as f:
+            data = f.read()
+
+    try:
+        dump = find_dump(data)
+    except DumpError as err:
+        sys.exit(f"trace_decode: {err}")
+
+    rows = report(dump)
+    if args.json:
+        json.dump({"now_us": dump["now_us"], "stages": rows}, sys.stdout, indent=2)
+        print()
+    else:
+        print_table(dump, rows)
+
+
+if __name__ == "__main__":
+    main()